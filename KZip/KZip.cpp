@@ -5,6 +5,53 @@
 
 #include "KZip.hpp"
 
+#ifdef _WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <io.h>
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#ifdef KZIP_IO_URING
+#    include <linux/io_uring.h>
+#    include <sys/syscall.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#    define KZIP_CRC32_CLMUL
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#    endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define KZIP_CRC32_ARM
+#    include <arm_acle.h>
+#    if defined(__linux__)
+#        include <asm/hwcap.h>
+#        include <sys/auxv.h>
+#    endif
+#endif
+
+// ===== Functions using instructions that the compiler may not target by default are compiled for those instructions
+// explicitly; they are only called if the CPU supports them.
+#if defined(__clang__) || defined(__GNUC__)
+#    define KZIP_TARGET_CLMUL __attribute__((target("pclmul,sse4.1")))
+#    if defined(__clang__)
+#        define KZIP_TARGET_ARM_CRC __attribute__((target("crc")))
+#    else
+#        define KZIP_TARGET_ARM_CRC __attribute__((target("+crc")))
+#    endif
+#else
+#    define KZIP_TARGET_CLMUL
+#    define KZIP_TARGET_ARM_CRC
+#endif
+
 namespace KZip {
 
         ZipEntry::ZipEntry(const std::string& filename) {
@@ -79,7 +126,7 @@ namespace KZip {
     };
 
     ZipEntryProxy::operator ZipEntry() { // NOLINT
-        return {getData<std::vector<unsigned char>>(), m_info};
+        return {getData<std::vector<unsigned char>>(), m_ziparchive->fileStat(m_slot)};
     }
 
     void ZipEntryProxy::clear()
@@ -88,29 +135,22 @@ namespace KZip {
     }
 
     std::string_view ZipEntryProxy::name() const {
-        return {m_info.m_filename};
+        return m_ziparchive->entryName(m_slot);
     }
 
     void ZipEntryProxy::setName(const std::string& entryname) {
         if (entryname.empty()) throw ZipLogicError("Entry name must not be empty");
         if (name() == entryname) return;
-        if (m_ziparchive->hasEntry(entryname)) m_ziparchive->deleteEntry(entryname);
-
-#if _MSC_VER    // On MSVC, use the safe version of strcpy
-        strcpy_s(m_info.m_filename, sizeof m_info.m_filename, entryname.c_str());
-        strcpy_s(m_info.m_comment, sizeof m_info.m_comment, "");
-#else    // Otherwise, use the unsafe version as fallback :(
-        strncpy(m_info.m_filename, entryname.c_str(), sizeof m_info.m_filename);    // NOLINT
-        strncpy(m_info.m_comment, "", sizeof m_info.m_comment);                // NOLINT
-#endif
 
+        // ===== The archive owns the name index, so the renaming is delegated to the archive object.
+        m_ziparchive->renameEntry(m_slot, entryname);
     }
 
-    ZipEntryMetaData ZipEntryProxy::metadata() const { return ZipEntryMetaData(m_info); }
+    ZipEntryMetaData ZipEntryProxy::metadata() const { return { record(), name() }; }
 
-    ZipEntryProxy::ZipEntryProxy(KZip::Impl::ZipArchive* archive, mz_zip_archive_file_stat info) : m_ziparchive(archive),
-                                                                                                   m_archive(&archive->m_archive),
-                                                                                                   m_info(info) {}
+    ZipEntryProxy::ZipEntryProxy(KZip::Impl::ZipArchive* archive, std::size_t slot) : m_ziparchive(archive),
+                                                                                      m_archive(&archive->m_archive),
+                                                                                      m_slot(slot) {}
 
     ZipEntryProxy::ZipEntryProxy(const ZipEntryProxy& other) = default;
 
@@ -118,8 +158,8 @@ namespace KZip {
 
     ZipEntryProxy& ZipEntryProxy::operator=(ZipEntryProxy&& other) noexcept = default;
 
-    const mz_zip_archive_file_stat& ZipEntryProxy::stats() const {
-        return m_info;
+    const Impl::ZipEntryRecord& ZipEntryProxy::record() const {
+        return m_ziparchive->record(m_slot);
     }
 
     bool ZipEntryProxy::isUpdated() const {
@@ -130,387 +170,3519 @@ namespace KZip {
         if (isUpdated())
             return m_data.has_value() ? m_data.value().size() : 0;
 
-        return m_info.m_uncomp_size;
+        return record().uncompressedSize;
     }
 
     const std::vector<unsigned char>& ZipEntryProxy::rawData() const {
         return m_data.value();
     }
 
-} // namespace KZip
+    std::size_t ZipEntryProxy::readInto(void* buffer, std::size_t size, ZipVerification verification) const
+    {
+        // ===== New or modified entries are copied from memory; entries without data are empty.
+        if (isUpdated()) {
+            if (size < m_data->size()) throw ZipLogicError("KZip Error: Buffer too small for entry '" + std::string(name()) + "'");
+            if (!m_data->empty()) std::memcpy(buffer, m_data->data(), m_data->size());
+            return m_data->size();
+        }
 
-namespace KZip::Impl {
+        const auto& info = record();
+        if (!info.isInArchive || info.isDirectory) return 0;
+        if (size < info.uncompressedSize) throw ZipLogicError("KZip Error: Buffer too small for entry '" + std::string(name()) + "'");
+
+        // ===== If the cache is enabled, the data is copied from there, if available.
+        auto& cache     = m_ziparchive->m_cache;
+        auto  isCaching = false;
+        {
+            auto guard = m_ziparchive->lock();
+            isCaching  = cache.isEnabled();
+            if (const auto* data = isCaching ? cache.find(info.fileIndex) : nullptr) {
+                if (!data->empty()) std::memcpy(buffer, data->data(), data->size());
+                return data->size();
+            }
+        }
+
+        // ===== Deflated entries are decompressed with the inflate engine of the archive, if it isn't miniz.
+        auto isVerify = m_ziparchive->isVerifying(m_slot, verification);
+        if (!m_ziparchive->inflateInto(m_slot, buffer, isVerify)) {
+            // ===== The metadata from the entry record is passed to miniz, so that it doesn't have to decode the central
+            // directory header again. Compressed data in an archive file is read through a buffer kept per thread.
+            auto stat = m_ziparchive->fileStat(m_slot);
+
+            thread_local std::vector<unsigned char> readBuffer(MZ_ZIP_MAX_IO_BUF_SIZE);
+            auto* userBuffer     = m_archive->m_pState->m_pMem ? nullptr : readBuffer.data();
+            auto  userBufferSize = m_archive->m_pState->m_pMem ? 0 : readBuffer.size();
+            auto  flags          = isVerify ? 0 : mz_uint { MZ_ZIP_FLAG_SKIP_CRC32_CHECK };
+            if (!mz_zip_reader_extract_to_mem_no_alloc1(m_archive, info.fileIndex, buffer, size, flags, userBuffer, userBufferSize, &stat)) {
+                throw ZipRuntimeError(mz_zip_get_error_string(m_archive->m_last_error));
+            }
+            if (isVerify) m_ziparchive->setVerified(m_slot);
+        }
 
-    ZipEntryWrapper::ZipEntryWrapper(const ZipEntryProxy& entry) : m_entry(entry) {}
+        auto count = static_cast<std::size_t>(info.uncompressedSize);
+        if (isCaching) {
+            const auto* data  = static_cast<const unsigned char*>(buffer);
+            auto        copy  = std::vector<unsigned char>(data, data + count);
+            auto        guard = m_ziparchive->lock();
+            if (cache.isEnabled()) cache.insert(info.fileIndex, std::move(copy));
+        }
 
-    const ZipEntryProxy& ZipEntryWrapper::entry() const {
-        return m_entry;
+        return count;
     }
 
-    ZipEntryProxy& ZipEntryWrapper::entry() {
-        return m_entry;
+    std::size_t ZipEntryProxy::read(uint64_t offset, void* buffer, std::size_t size) const
+    {
+        // ===== New or modified entries are copied from memory.
+        if (isUpdated()) {
+            if (offset >= m_data->size()) return 0;
+            auto count = static_cast<std::size_t>(std::min<uint64_t>(size, m_data->size() - offset));
+            std::memcpy(buffer, m_data->data() + offset, count);
+            return count;
+        }
+
+        return m_ziparchive->readRange(m_slot, offset, buffer, size);
     }
 
+    void ZipEntryProxy::uncache() { m_ziparchive->uncache(m_slot); }
 
-    ZipArchive::ZipArchive() = default;
+    ZipEntryReader ZipEntryProxy::openStream(ZipVerification verification) const
+    {
+        // ===== New or modified entries are read from memory; entries without data are empty.
+        if (isUpdated()) return { m_data->data(), m_data->size() };
 
-    ZipArchive::ZipArchive(ZipArchive&& other) noexcept = default;
+        const auto& info = record();
+        if (!info.isInArchive) return { nullptr, 0 };
 
-    ZipArchive::~ZipArchive() { close(); }
+        auto flags = m_ziparchive->isVerifying(m_slot, verification) ? 0 : mz_uint { MZ_ZIP_FLAG_SKIP_CRC32_CHECK };
+        return { m_archive, m_ziparchive->fileStat(m_slot), flags };
+    }
 
-    ZipArchive& ZipArchive::operator=(ZipArchive&& other) = default;
+    ZipCompressedData ZipEntryProxy::rawCompressed() const
+    {
+        // ===== New or modified entries are returned as stored, referring to the data held by the entry.
+        if (isUpdated()) {
+            ZipCompressedData result;
+            result.m_data             = m_data->data();
+            result.m_size             = m_data->size();
+            result.m_uncompressedSize = m_data->size();
+            result.m_crc32            = static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, m_data->data(), m_data->size()));
+            return result;
+        }
 
-    void ZipArchive::create(const fs::path& fileName)
+        return m_ziparchive->compressedData(m_slot);
+    }
+
+    std::optional<ZipByteView> ZipEntryProxy::view() const
     {
-        // ===== Prepare an archive file;
-        mz_zip_archive archive = mz_zip_archive();
-        mz_zip_writer_init_file(&archive, fileName.string().c_str(), 0);
+        // ===== New or modified entries are viewed in memory; entries without data are empty.
+        if (isUpdated()) return ZipByteView(m_data->data(), m_data->size());
 
-        // ===== Finalize and close the temporary archive
-        mz_zip_writer_finalize_archive(&archive);
-        mz_zip_writer_end(&archive);
+        const auto& info = record();
+        if (!info.isInArchive || info.isDirectory) return ZipByteView();
 
-        // ===== Validate the temporary file
-        mz_zip_error errordata { mz_zip_error() };
-        if (!mz_zip_validate_file_archive(fileName.string().c_str(), 0, &errordata)) {
-            throw ZipRuntimeError(mz_zip_get_error_string(errordata));
-        }
+        // ===== Only stored entries in a memory mapped archive can be viewed in place.
+        const auto* memory = static_cast<const unsigned char*>(m_archive->m_pState->m_pMem);
+        if (!memory || info.method != 0 || info.isEncrypted || info.compressedSize != info.uncompressedSize) return std::nullopt;
 
-        // ===== If everything is OK, open the newly created archive.
-        open(fileName);
+        return ZipByteView(memory + m_ziparchive->dataOffset(m_slot), static_cast<std::size_t>(info.uncompressedSize));
     }
 
-    void ZipArchive::open(const fs::path& fileName)
+    ZipEntryReader ZipEntryProxy::openRawStream() const
     {
-        if (isOpen()) close();
+        // ===== New or modified entries are read from memory, as stored; entries without data are empty.
+        if (isUpdated()) return { m_data->data(), m_data->size() };
 
-        // ===== Open the zip archive file. If unsuccessful, throw exception.
-        m_archivePath = fileName;
-        if (!mz_zip_reader_init_file(&m_archive, m_archivePath.string().c_str(), 0)) {
-            throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
-        }
-        m_isOpen = true;
+        const auto& info = record();
+        if (!info.isInArchive) return { nullptr, 0 };
 
-        // ===== Iterate through the archive and add the entries to the internal data structure
-        mz_zip_archive_file_stat info;
-        for (unsigned int i = 0; i < mz_zip_reader_get_num_files(&m_archive); ++i) {
-            if (!mz_zip_reader_file_stat(&m_archive, i, &info)) {
-                throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
-            }
+        return { m_archive, m_ziparchive->fileStat(m_slot), MZ_ZIP_FLAG_COMPRESSED_DATA };
+    }
 
-            if (info.m_file_index > m_currentIndex) m_currentIndex = info.m_file_index;
-            m_zipEntryData.emplace_back(ZipEntryProxy(this, info));
-        }
+} // namespace KZip
 
-        // ===== Remove entries with identical names. The newest entries will be retained.
-        // TODO (troldal): Can this be done without reversing the list twice?
-        auto isEqual = [](const ZipEntryWrapper& a, const ZipEntryWrapper& b) {
-            return strcmp(a.entry().stats().m_filename, b.entry().stats().m_filename) == 0;
-        };
-        std::reverse(m_zipEntryData.begin(), m_zipEntryData.end());
-        m_zipEntryData.erase(std::unique(m_zipEntryData.begin(), m_zipEntryData.end(), isEqual), m_zipEntryData.end());
-        std::reverse(m_zipEntryData.begin(), m_zipEntryData.end());
+namespace KZip {
 
-        // ===== Add folder entries if they don't exist
-        for (auto& entry : entryNames(ZipFlags::Directories)) {
-            if (entry.find('/') != std::string::npos) {
-                addEntry(entry.substr(0, entry.rfind('/') + 1));
-            }
-        }
+    ZipEntryReader::ZipEntryReader(mz_zip_archive* archive, const mz_zip_archive_file_stat& info, mz_uint flags)
+        : m_archive(archive),
+          m_state(mz_zip_reader_extract_iter_new1(archive, info.m_file_index, flags, &info)),
+          m_size(flags & MZ_ZIP_FLAG_COMPRESSED_DATA ? info.m_comp_size : info.m_uncomp_size)
+    {
+        if (!m_state) throw ZipRuntimeError(mz_zip_get_error_string(m_archive->m_last_error));
     }
 
-    ZipEntryProxy& ZipArchive::addEntry(const std::string& path)
+    ZipEntryReader::ZipEntryReader(const unsigned char* data, uint64_t size) : m_data(data), m_size(size) {}
+
+    ZipEntryReader::ZipEntryReader(ZipEntryReader&& other) noexcept
+        : m_archive(other.m_archive),
+          m_state(std::exchange(other.m_state, nullptr)),
+          m_data(other.m_data),
+          m_size(other.m_size),
+          m_position(other.m_position),
+          m_isFailed(other.m_isFailed)
+    {}
+
+    ZipEntryReader& ZipEntryReader::operator=(ZipEntryReader&& other) noexcept
     {
-        if (!isOpen()) throw ZipLogicError("Function call: addEntry(). Archive is invalid or not open!");
+        if (this == &other) return *this;
 
-        // ===== Check if an entry with the given name already exists in the archive.
-        auto files  = entryNames(ZipFlags::Files);
-        auto result = std::find_if(m_zipEntryData.begin(), m_zipEntryData.end(), [&](const ZipEntryWrapper& item) {
-            return strcmp(item.entry().stats().m_filename, path.c_str()) == 0;    // NOLINT
-        });
+        if (m_state) mz_zip_reader_extract_iter_free(m_state);
+        m_archive  = other.m_archive;
+        m_state    = std::exchange(other.m_state, nullptr);
+        m_data     = other.m_data;
+        m_size     = other.m_size;
+        m_position = other.m_position;
+        m_isFailed = other.m_isFailed;
 
-        //                if (result != m_zipEntryData.end()) throw ZipLogicError("KZip Error: Entry '" + path + "' already exists");
+        return *this;
+    }
 
-        // ===== Ensure that all folders and subfolders in the path name have an entry in the archive
-        auto folders  = entryNames(ZipFlags::Directories);
-        auto position = uint64_t { 0 };
-        while (path.find('/', position) != std::string::npos) {
-            position        = path.find('/', position) + 1;
-            auto folderName = path.substr(0, position);
+    ZipEntryReader::~ZipEntryReader()
+    {
+        if (m_state) mz_zip_reader_extract_iter_free(m_state);
+    }
 
-            // ===== If folderName isn't registered in the archive, add it.
-            if (std::find(folders.begin(), folders.end(), folderName) == folders.end()) {
-                m_zipEntryData.emplace_back(ZipEntryProxy(this, createInfo(folderName)));
-            }
+    std::size_t ZipEntryReader::read(void* buffer, std::size_t size)
+    {
+        if (m_isFailed) throw ZipLogicError("The entry data can't be read after a failed read.");
+        auto count = static_cast<std::size_t>(std::min<uint64_t>(size, m_size - m_position));
+
+        // ===== Data held in memory is simply copied.
+        if (!m_state) {
+            if (count > 0) std::memcpy(buffer, m_data + m_position, count);
+            m_position += count;
+            return count;
         }
 
-        // ===== Create a new entry and return the reference
-        if (result != m_zipEntryData.end()) {
-            *result = ZipEntryWrapper(ZipEntryProxy(this, createInfo(path)));
-            return result->entry();
+        // ===== Otherwise, the data is decompressed by miniz. A short read before the end of the entry means that the
+        // data couldn't be read or decompressed.
+        if (count > 0) {
+            auto bytesRead = mz_zip_reader_extract_iter_read(m_state, buffer, count);
+            m_position += bytesRead;
+            if (bytesRead != count || m_state->status < TINFL_STATUS_DONE) {
+                mz_zip_reader_extract_iter_free(std::exchange(m_state, nullptr));
+                m_isFailed = true;
+                throw ZipRuntimeError(mz_zip_get_error_string(m_archive->m_last_error));
+            }
         }
-        return m_zipEntryData.emplace_back(ZipEntryProxy(this, createInfo(path))).entry();
+
+        if (eof()) finish();
+        return count;
     }
 
-    void ZipArchive::deleteEntry(const std::string& name)
+    void ZipEntryReader::finish()
     {
-        if (!isOpen()) throw ZipLogicError("Function call: deleteEntry(). Archive is invalid or not open!");
+        // ===== The last bytes may have been returned before the decompressor has seen the end of the compressed data,
+        // so the remaining input is drained before the size and checksum are verified by miniz.
+        auto status = m_state->status;
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT || status == TINFL_STATUS_HAS_MORE_OUTPUT) {
+            unsigned char extra = 0;
+            mz_zip_reader_extract_iter_read(m_state, &extra, 1);
+        }
 
-        // ===== When saving, only the entries present in the vector will be saved or copied from the original file.
-        m_zipEntryData.erase(std::remove_if(m_zipEntryData.begin(),
-                                            m_zipEntryData.end(),
-                                            [&](const ZipEntryWrapper& entry) { return strcmp(name.c_str(), entry.entry().stats().m_filename) == 0; }),
-                             m_zipEntryData.end());
+        if (!mz_zip_reader_extract_iter_free(std::exchange(m_state, nullptr))) {
+            m_isFailed = true;
+            throw ZipRuntimeError(mz_zip_get_error_string(m_archive->m_last_error));
+        }
     }
 
-    ZipEntryProxy& ZipArchive::entry(const std::string& path)
+    ZipEntryStream::ZipEntryStream(ZipEntryReader reader, std::size_t windowSize)
+        : std::istream(nullptr),
+          m_buffer(std::move(reader), windowSize)
     {
-        if (!isOpen()) throw ZipLogicError("Cannot get entry from empty ZipArchive object!");
+        rdbuf(&m_buffer);
+    }
 
-        // ===== Look up file_stat object.
-        auto stats = std::find_if(m_zipEntryData.begin(), m_zipEntryData.end(), [&](const ZipEntryWrapper& data) {
-            return strcmp(path.c_str(), data.entry().stats().m_filename) == 0;
-        });
+    ZipEntryStream::~ZipEntryStream() = default;
 
-        if (stats == m_zipEntryData.end()) throw ZipLogicError("KZip Error: Entry '" + path + "' does not exist");
+    ZipEntryStream::Buffer::Buffer(ZipEntryReader reader, std::size_t windowSize)
+        : m_reader(std::move(reader)),
+          m_window(std::max<std::size_t>(windowSize, 1))
+    {}
 
-        return stats->entry();
+    ZipEntryStream::Buffer::int_type ZipEntryStream::Buffer::underflow()
+    {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+        auto count = m_reader.read(m_window.data(), m_window.size());
+        if (count == 0) return traits_type::eof();
+
+        setg(m_window.data(), m_window.data(), m_window.data() + count);
+        return traits_type::to_int_type(*gptr());
     }
 
-    const ZipEntryProxy& ZipArchive::entry(const std::string& path) const
-    {
-        if (!isOpen()) throw ZipLogicError("Cannot get entry from empty ZipArchive object!");
+} // namespace KZip
 
-        // ===== Look up file_stat object.
-        auto stats = std::find_if(m_zipEntryData.begin(), m_zipEntryData.end(), [&](const ZipEntryWrapper& data) {
-            return strcmp(path.c_str(), data.entry().stats().m_filename) == 0;
-        });
+namespace KZip {
+
+    std::string_view ZipEntryView::name() const { return m_archive->entryName(m_slot); }
 
-        if (stats == m_zipEntryData.end()) throw ZipLogicError("KZip Error: Entry '" + path + "' does not exist");
+    ZipEntryMetaData ZipEntryView::metadata() const { return { m_archive->record(m_slot), name() }; }
 
-        return stats->entry();
+    ZipEntryProxy& ZipEntryView::entry() const { return m_archive->proxy(m_slot); }
+
+    ZipEntryIterator::ZipEntryIterator(Impl::ZipArchive*                     archive,
+                                       const std::size_t*                    slots,
+                                       std::size_t                           position,
+                                       std::size_t                           last,
+                                       ZipFlags                              flags,
+                                       std::shared_ptr<const Impl::ZipGlob> glob)
+        : m_slots(slots),
+          m_position(position),
+          m_last(last),
+          m_flags(flags),
+          m_glob(std::move(glob))
+    {
+        m_view.m_archive = archive;
+        skipUnmatched();
     }
 
-    std::vector<std::string> ZipArchive::entryNames(ZipFlags flags) const
+    ZipEntryIterator::reference ZipEntryIterator::operator*() const { return m_view; }
+
+    ZipEntryIterator::pointer ZipEntryIterator::operator->() const { return &m_view; }
+
+    ZipEntryIterator& ZipEntryIterator::operator++()
     {
-        return entryNames("", flags);
+        ++m_position;
+        skipUnmatched();
+        return *this;
     }
 
-    std::vector<std::string> ZipArchive::entryNames(const std::string& path, ZipFlags flags) const
+    ZipEntryIterator ZipEntryIterator::operator++(int)    // NOLINT
     {
-        if (!isOpen()) throw ZipLogicError("Function call: entryNames(). Archive is invalid or not open!");
+        auto result = *this;
+        ++(*this);
+        return result;
+    }
 
-        std::vector<std::string> result;
+    bool ZipEntryIterator::operator==(const ZipEntryIterator& other) const { return m_position == other.m_position && m_slots == other.m_slots; }
 
-        // ===== Iterate through all the entries in the archive
-        for (const auto& item : m_zipEntryData) {
-            // ===== If directories should be included and the current entry is a directory, add it to the result.
-            if (path.empty() ||
-                (strlen(item.entry().stats().m_filename) >= path.size() &&
-                 std::string_view(item.entry().stats().m_filename, path.size()) == path))
-            {
-                if (static_cast<bool>(flags & ZipFlags::Directories) && item.entry().stats().m_is_directory) {
-                    result.emplace_back(item.entry().stats().m_filename);
-                    continue;
-                }
+    bool ZipEntryIterator::operator!=(const ZipEntryIterator& other) const { return !(*this == other); }
+
+    void ZipEntryIterator::skipUnmatched()
+    {
+        auto* archive = m_view.m_archive;
+        while (m_position < m_last) {
+            auto slot = m_slots ? m_slots[m_position] : m_position;
+            if (!archive->matchesFlags(slot, m_flags)) {
+                ++m_position;
+                continue;
+            }
 
-                // ===== If files should be included and the current entry is a file, add it to the result.
-                if (static_cast<bool>(flags & ZipFlags::Files) && !item.entry().stats().m_is_directory) {
-                    result.emplace_back(item.entry().stats().m_filename);
+            // ===== If the name doesn't match the pattern, and neither can any other name in the same folder, skip the
+            // whole folder. As the slots are sorted by name, the entries in the folder are contiguous.
+            if (m_glob) {
+                auto name   = archive->entryName(slot);
+                auto result = m_glob->match(name);
+                if (!result.isMatch) {
+                    m_position = result.pruneLength > 0 ? archive->skipPrefix(m_slots, m_position, m_last, name.substr(0, result.pruneLength))
+                                                        : m_position + 1;
                     continue;
                 }
             }
-        }
 
-        return result;
+            m_view.m_slot = slot;
+            return;
+        }
     }
 
-    uint16_t ZipArchive::entryCount(ZipFlags flags) const {
-        return entryCount("", flags);
-    }
+    ZipEntryRange::ZipEntryRange(ZipEntryIterator first, ZipEntryIterator last) : m_first(first), m_last(last) {}
 
-    uint16_t ZipArchive::entryCount(const std::string& path, ZipFlags flags) const {
-        return entryNames(path, flags).size();
-    }
+    ZipEntryIterator ZipEntryRange::begin() const { return m_first; }
 
-    bool ZipArchive::hasEntry(const std::string& entryName) const
-    {
-        if (!isOpen()) throw ZipLogicError("Cannot call HasEntry on empty ZipArchive object!");
+    ZipEntryIterator ZipEntryRange::end() const { return m_last; }
 
-        return std::find_if(m_zipEntryData.begin(), m_zipEntryData.end(), [&](const ZipEntryWrapper& data) {
-                   return strcmp(entryName.c_str(), data.entry().stats().m_filename) == 0;
-               }) != m_zipEntryData.end();    // NOLINT
-    }
+} // namespace KZip
 
-    void ZipArchive::close()
-    {
-        if (isOpen()) {
-            mz_zip_reader_end(&m_archive);
+namespace KZip::Impl {
+
+    namespace {
+        /**
+         * @brief Copy the metadata from a mz_zip_archive_file_stat structure to an entry record. The name is not copied.
+         * @param record The entry record.
+         * @param info The file stats read from the archive file.
+         */
+        void loadStats(ZipEntryRecord& record, const mz_zip_archive_file_stat& info)
+        {
+            record.localHeaderOffset = info.m_local_header_ofs;
+            record.compressedSize    = info.m_comp_size;
+            record.uncompressedSize  = info.m_uncomp_size;
+            record.time              = info.m_time;
+            record.fileIndex         = info.m_file_index;
+            record.crc32             = info.m_crc32;
+            record.method            = info.m_method;
+            record.isDirectory       = info.m_is_directory;
+            record.isEncrypted       = info.m_is_encrypted;
+            record.isSupported       = info.m_is_supported;
+            record.isLoaded          = true;
         }
-        m_zipEntryData.clear();
-        m_archivePath.clear();
-        m_isOpen = false;
-    }
 
-    bool ZipArchive::isOpen() const { return m_isOpen; }
+        /**
+         * @brief The last DOS timestamp converted by decodeStats(). Entries in an archive typically share a few
+         * timestamps, and the conversion (which uses mktime) is by far the most expensive part of decoding an entry.
+         */
+        struct DosTimeCache
+        {
+            uint32_t  dosTime { MZ_UINT32_MAX }; /**< The DOS date and time, as stored in the central directory. */
+            MZ_TIME_T time { 0 };                /**< The converted time. */
+        };
 
-    void ZipArchive::save(fs::path filename)
-    {
-        if (!isOpen()) throw ZipLogicError("Function call: save(). Archive is invalid or not open!");
+        /**
+         * @brief Decode the metadata of an entry directly from its central directory header.
+         * @details This is equivalent to loadStats() with the result of mz_zip_reader_file_stat(), but without copying
+         * the name and comment, and with the timestamp conversion cached. Entries with sizes or offsets stored in a
+         * zip64 extra field are decoded by miniz.
+         */
+        void decodeStats(ZipEntryRecord& record, mz_zip_archive& archive, uint32_t fileIndex, DosTimeCache& cache)
+        {
+            const auto* header = mz_zip_get_cdh(&archive, fileIndex);
+            if (!header) throw ZipRuntimeError("KZip Error: Invalid central directory index");
+
+            record.localHeaderOffset = MZ_READ_LE32(header + MZ_ZIP_CDH_LOCAL_HEADER_OFS);
+            record.compressedSize    = MZ_READ_LE32(header + MZ_ZIP_CDH_COMPRESSED_SIZE_OFS);
+            record.uncompressedSize  = MZ_READ_LE32(header + MZ_ZIP_CDH_DECOMPRESSED_SIZE_OFS);
+            if (std::max({ record.localHeaderOffset, record.compressedSize, record.uncompressedSize }) == MZ_UINT32_MAX) {
+                mz_zip_archive_file_stat info;
+                if (!mz_zip_reader_file_stat(&archive, fileIndex, &info)) throw ZipRuntimeError(mz_zip_get_error_string(archive.m_last_error));
+                loadStats(record, info);
+                return;
+            }
 
-        if (filename.empty()) {
-            filename = m_archivePath;
+            auto dosTime = MZ_READ_LE32(header + MZ_ZIP_CDH_FILE_TIME_OFS);
+            if (dosTime != cache.dosTime) {
+                cache.dosTime = dosTime;
+                cache.time    = mz_zip_dos_to_time_t(static_cast<int>(dosTime & 0xFFFFU), static_cast<int>(dosTime >> 16U));
+            }
+
+            record.time        = cache.time;
+            record.fileIndex   = fileIndex;
+            record.crc32       = MZ_READ_LE32(header + MZ_ZIP_CDH_CRC32_OFS);
+            record.method      = MZ_READ_LE16(header + MZ_ZIP_CDH_METHOD_OFS);
+            record.isDirectory = mz_zip_reader_is_file_a_directory(&archive, fileIndex);
+            record.isEncrypted = mz_zip_reader_is_file_encrypted(&archive, fileIndex);
+            record.isSupported = mz_zip_reader_is_file_supported(&archive, fileIndex);
+            record.isLoaded    = true;
         }
 
-        // ===== Lambda function for generating a gandom filename
-        auto generateRandomName = []() {
-            static const std::string letters = "abcdefghijklmnopqrstuvwxyz0123456789";
+        /**
+         * @brief The header of a sidecar index file (see OpenMode::Indexed).
+         * @details The header is followed by the entry records, the name arena, the sorted slots and the name index.
+         */
+        struct IndexFileHeader
+        {
+            char     magic[8] { 'K', 'Z', 'I', 'P', 'I', 'D', 'X', '\0' }; /**< Identifies the file as a KZip index file. */
+            uint32_t version { 1 };                                         /**< The version of the file format. */
+            uint32_t recordSize { sizeof(ZipEntryRecord) };                 /**< The size of an entry record. */
+            uint32_t wordSize { sizeof(std::size_t) };                      /**< The size of a slot number. */
+            uint32_t reserved { 0 };
+            uint64_t archiveSize { 0 };                                     /**< The size of the archive file. */
+            int64_t  archiveTime { 0 };                                     /**< The modification time of the archive file. */
+            uint64_t fileCount { 0 };                                       /**< The number of entries in the archive file. */
+            uint64_t entryCount { 0 };                                      /**< The number of records. */
+            uint64_t nameArenaSize { 0 };                                   /**< The size of the name arena. */
+            uint64_t sortedCount { 0 };                                     /**< The number of sorted slots. */
+            uint64_t deletedCount { 0 };                                    /**< The number of deleted (i.e. shadowed) records. */
+            uint64_t currentIndex { 0 };                                    /**< The last file index assigned to an entry. */
+        };
 
-            std::random_device                          rand_dev;
-            std::mt19937                                generator(rand_dev());
-            std::uniform_int_distribution<unsigned int> distr(0, letters.size() - 1);
+        /**
+         * @brief The smallest number of entries processed by each thread when building the tables of an archive.
+         * Below this, the overhead of starting a thread exceeds the gain.
+         */
+        constexpr std::size_t MinEntriesPerThread = 16384;
+
+        /**
+         * @brief The largest number of bytes read at once when extracting a list of entries (see ZipArchive::extract).
+         * Entries with more compressed data are read on their own.
+         */
+        constexpr uint64_t MaxBatchSize = 4 * 1024 * 1024;
+
+        /**
+         * @brief The largest gap between two entries read in the same batch. Reading the data in between is cheaper than
+         * issuing another read.
+         */
+        constexpr uint64_t MaxBatchGap = 64 * 1024;
+
+        /**
+         * @brief The number of bytes allowed for the extra field of a local header, when estimating the size of an entry
+         * in the archive file. Entries with larger extra fields are read on their own.
+         */
+        constexpr uint64_t LocalExtraAllowance = 256;
+
+        /**
+         * @brief The largest number of reads in flight when extracting entries asynchronously (see ZipArchive::extractAsync).
+         */
+        constexpr unsigned AsyncQueueDepth = 64;
+
+        /**
+         * @brief The largest number of bytes read at once for a single entry when extracting entries asynchronously.
+         * Entries with more compressed data are read and decompressed by a worker, into a buffer of the uncompressed size.
+         */
+        constexpr uint64_t MaxAsyncReadSize = 64 * 1024 * 1024;
+
+        /**
+         * @brief The largest number of bytes held in read buffers, and in the buffers of entries read by the workers,
+         * when extracting entries asynchronously. Reads are not submitted until the workers have caught up.
+         */
+        constexpr uint64_t MaxAsyncBufferSize = 256 * 1024 * 1024;
+
+        /**
+         * @brief Estimate the end of an entry in the archive file, i.e. the end of its compressed data.
+         * @details The estimate is based on the central directory, as the size of the extra field in the local header is
+         * only known once the local header has been read.
+         */
+        uint64_t estimatedEnd(const ZipEntryRecord& info, uint64_t archiveSize)
+        {
+            auto end = info.localHeaderOffset + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + info.nameLength + LocalExtraAllowance + info.compressedSize;
+            return std::min(end, archiveSize);
+        }
 
-            std::string result = ".~$";
-            for (int i = 0; i < 12; ++i) {    // NOLINT
-                result += letters[distr(generator)];
+        /**
+         * @brief Get the number of chunks parallelFor() splits a range into.
+         */
+        std::size_t chunkCount(std::size_t count, std::size_t threadCount, std::size_t minChunkSize)
+        {
+            return std::max<std::size_t>(1, std::min(threadCount, count / minChunkSize));
+        }
+
+        /**
+         * @brief Call a function for consecutive chunks of the range [0, count), using up to threadCount threads.
+         * @details The function is called with the first and last index of the chunk, and the chunk number. The first
+         * chunk is processed on the calling thread. If the function throws for any chunk, the exception is rethrown
+         * once all chunks have been processed.
+         */
+        template<typename Function>
+        void parallelFor(std::size_t count, std::size_t threadCount, std::size_t minChunkSize, const Function& function)
+        {
+            auto chunks = chunkCount(count, threadCount, minChunkSize);
+            if (chunks == 1) {
+                function(std::size_t { 0 }, count, std::size_t { 0 });
+                return;
             }
 
-            return result + ".tmp";
-        };
+            std::vector<std::exception_ptr> errors(chunks);
+            auto                            run = [&](std::size_t chunk) {
+                try {
+                    function(count * chunk / chunks, count * (chunk + 1) / chunks, chunk);
+                }
+                catch (...) {
+                    errors[chunk] = std::current_exception();
+                }
+            };
 
-        // ===== Generate a random file name with the same path as the current file
-        fs::path tempPath = filename.parent_path() /= generateRandomName();
+            std::vector<std::thread> threads;
+            threads.reserve(chunks - 1);
+            for (std::size_t chunk = 1; chunk < chunks; ++chunk) threads.emplace_back(run, chunk);
+            run(0);
+            for (auto& thread : threads) thread.join();
 
-        // ===== Prepare an temporary archive file with the random filename;
-        mz_zip_archive tempArchive = mz_zip_archive();
-        mz_zip_writer_init_file(&tempArchive, tempPath.string().c_str(), 0);
+            for (const auto& error : errors)
+                if (error) std::rethrow_exception(error);
+        }
 
-        // ===== Iterate through the ZipEntries and add entries to the temporary file
-        for (auto& entry : m_zipEntryData) {
-            if (entry.entry().stats().m_is_directory) continue;
-            if (!entry.entry().isUpdated()) {
-                if (!mz_zip_writer_add_from_zip_reader(&tempArchive, &m_archive, entry.entry().stats().m_file_index)) {
-                    throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
-                }
+        /**
+         * @brief The WorkerReader class is a reader of an archive file, for use by a worker thread, so that threads don't
+         * share the file position of the reader held by the archive object.
+         * @details If the archive is memory mapped, the reader reads from the mapping. The reader is opened on first use.
+         */
+        class WorkerReader
+        {
+        public:
+            WorkerReader(const fs::path& path, const ZipFileMapping& mapping) : m_path(path), m_mapping(mapping) {}
+            WorkerReader(const WorkerReader& other)            = delete;
+            WorkerReader& operator=(const WorkerReader& other) = delete;
+            ~WorkerReader()
+            {
+                if (m_isOpen) mz_zip_reader_end(&m_archive);
             }
 
-            else {
-                if (!mz_zip_writer_add_mem(&tempArchive,
-                                           entry.entry().stats().m_filename,    // NOLINT
-                                           entry.entry().rawData().data(),
-                                           entry.entry().rawData().size(),
-                                           MZ_DEFAULT_COMPRESSION))
-                {
-                    throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
-                }
+            mz_zip_archive& archive()
+            {
+                if (m_isOpen) return m_archive;
+
+                auto flags    = MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY;
+                auto isOpened = m_mapping.isMapped() ? mz_zip_reader_init_mem(&m_archive, m_mapping.data(), m_mapping.size(), flags)
+                                                     : mz_zip_reader_init_file(&m_archive, m_path.string().c_str(), flags);
+                if (!isOpened) throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
+
+                m_isOpen = true;
+                return m_archive;
             }
-        }
 
-        // ===== Finalize and close the temporary archive
-        mz_zip_writer_finalize_archive(&tempArchive);
-        mz_zip_writer_end(&tempArchive);
+        private:
+            const fs::path&       m_path;                       /**< The path of the archive file. */
+            const ZipFileMapping& m_mapping;                    /**< The mapping of the archive file, if memory mapped. */
+            mz_zip_archive        m_archive = mz_zip_archive(); /**< The miniz reader. */
+            bool                  m_isOpen { false };           /**< true if the reader has been opened. */
+        };
 
-        // ===== Validate the temporary file
-        mz_zip_error errordata = {};
-        if (!mz_zip_validate_file_archive(tempPath.string().c_str(), 0, &errordata)) {
-            throw ZipRuntimeError(mz_zip_get_error_string(errordata));
+        /**
+         * @brief Read from a file at the given position, without using or changing the file position, so that any number
+         * of threads can read from the file at once.
+         * @return The number of bytes read. It is less than the given size only at the end of the file, or on errors.
+         */
+        std::size_t readFileAt(std::FILE* file, uint64_t position, void* buffer, std::size_t size)
+        {
+            auto*       data  = static_cast<char*>(buffer);
+            std::size_t count = 0;
+
+#ifdef _WIN32
+            auto* handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));    // NOLINT
+            while (count < size) {
+                auto       chunk      = static_cast<DWORD>(std::min<std::size_t>(size - count, std::numeric_limits<DWORD>::max()));
+                DWORD      bytesRead  = 0;
+                OVERLAPPED overlapped = {};
+                overlapped.Offset     = static_cast<DWORD>(position + count);
+                overlapped.OffsetHigh = static_cast<DWORD>((position + count) >> 32);
+                if (!ReadFile(handle, data + count, chunk, &bytesRead, &overlapped) || bytesRead == 0) break;
+                count += bytesRead;
+            }
+#else
+            auto descriptor = fileno(file);
+            while (count < size) {
+                auto bytesRead = pread(descriptor, data + count, size - count, static_cast<off_t>(position + count));
+                if (bytesRead < 0 && errno == EINTR) continue;
+                if (bytesRead <= 0) break;
+                count += static_cast<std::size_t>(bytesRead);
+            }
+#endif
+
+            return count;
         }
 
-        // ===== Close the current archive, delete the file with input filename (if it exists), rename the temporary and call Open.
-        close();
-        nowide::remove(filename.string().c_str());                      // NOLINT
-        nowide::rename(tempPath.string().c_str(), filename.string().c_str());    // NOLINT
-        open(filename);
-    }
-
-    mz_zip_archive_file_stat ZipArchive::createInfo(const std::string& name)
-    {
-        mz_zip_archive_file_stat info;
-
-        info.m_file_index       = ++m_currentIndex;
-        info.m_central_dir_ofs  = 0;
-        info.m_version_made_by  = 0;
-        info.m_version_needed   = 0;
-        info.m_bit_flag         = 0;
-        info.m_method           = 0;
-        info.m_time             = std::time(nullptr);
-        info.m_crc32            = 0;
-        info.m_comp_size        = 0;
-        info.m_uncomp_size      = 0;
-        info.m_internal_attr    = 0;
-        info.m_external_attr    = 0;
-        info.m_local_header_ofs = 0;
-        info.m_comment_size     = 0;
-        info.m_is_directory     = (name.back() == '/');
-        info.m_is_encrypted     = false;
-        info.m_is_supported     = true;
+        /**
+         * @brief The read callback used by miniz in concurrent mode (see OpenMode::Concurrent). Unlike the default
+         * callback, which seeks the shared FILE object and reads from the current position, it uses positional reads.
+         */
+        std::size_t readAt(void* opaque, mz_uint64 offset, void* buffer, std::size_t size)
+        {
+            const auto& state = *static_cast<mz_zip_archive*>(opaque)->m_pState;
+            return readFileAt(state.m_pFile, offset + state.m_file_archive_start_ofs, buffer, size);
+        }
 
-#if _MSC_VER    // On MSVC, use the safe version of strcpy
-        strcpy_s(info.m_filename, sizeof info.m_filename, name.c_str());
-        strcpy_s(info.m_comment, sizeof info.m_comment, "");
-#else    // Otherwise, use the unsafe version as fallback :(
-        strncpy(info.m_filename, name.c_str(), sizeof info.m_filename);    // NOLINT
-        strncpy(info.m_comment, "", sizeof info.m_comment);                // NOLINT
+        /**
+         * @brief The ReadQueue class reads blocks of an archive file asynchronously (see ZipArchive::extractAsync).
+         * @details Reads are submitted with a tag, and completions are collected one at a time, in any order. If the
+         * library is built with io_uring support (the ENABLE_IO_URING CMake option) and the kernel provides it, the reads
+         * are submitted to an io_uring instance in batches, so that many reads are in flight at once. Otherwise, each read
+         * is done with a positional read when it is submitted.
+         * @note The buffers of reads in flight must remain valid until the reads are completed; the destructor waits for
+         * any reads still in flight.
+         */
+        class ReadQueue
+        {
+        public:
+            /**
+             * @brief Constructor.
+             * @param path The path of the archive file.
+             * @param depth The maximum number of reads in flight.
+             */
+            ReadQueue(const fs::path& path, unsigned depth) : m_file(std::fopen(path.string().c_str(), "rb")), m_depth(depth)
+            {
+                if (!m_file) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_FILE_OPEN_FAILED));
+#ifdef KZIP_IO_URING
+                setupRing();
 #endif
+            }
 
-        return info;
-    }
+            ReadQueue(const ReadQueue& other)            = delete;
+            ReadQueue& operator=(const ReadQueue& other) = delete;
 
-} // namespace KZip::Impl
+            ~ReadQueue()
+            {
+#ifdef KZIP_IO_URING
+                if (m_ring >= 0) {
+                    while (!m_reads.empty()) wait();
+                    releaseRing();
+                }
+#endif
+                std::fclose(m_file);
+            }
 
-namespace KZip {
+            /**
+             * @brief Get the maximum number of reads in flight.
+             */
+            unsigned depth() const { return m_depth; }
+
+            /**
+             * @brief Get the number of submitted reads that haven't been collected by wait().
+             */
+            std::size_t pending() const { return m_reads.size() + m_completed.size(); }
+
+            /**
+             * @brief Submit a read. At most depth() reads may be pending.
+             * @param tag The tag identifying the read.
+             * @param offset The position in the file.
+             * @param buffer The buffer to read into.
+             * @param size The number of bytes to read.
+             */
+            void submit(std::size_t tag, uint64_t offset, unsigned char* buffer, std::size_t size)
+            {
+#ifdef KZIP_IO_URING
+                if (m_ring >= 0 && size <= std::numeric_limits<uint32_t>::max()) {
+                    auto  tail  = *m_sqTail;
+                    auto  index = tail & *m_sqMask;
+                    auto& entry = m_sqes[index];
+                    entry       = io_uring_sqe();
+                    entry.opcode    = IORING_OP_READ;
+                    entry.fd        = fileno(m_file);
+                    entry.off       = offset;
+                    entry.addr      = reinterpret_cast<uint64_t>(buffer);    // NOLINT
+                    entry.len       = static_cast<uint32_t>(size);
+                    entry.user_data = tag;
+                    m_sqArray[index] = index;
+                    __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+                    m_reads.emplace(tag, Read { offset, buffer, size });
+                    ++m_unsubmitted;
+                    return;
+                }
+#endif
+                m_completed.emplace_back(tag, readFileAt(m_file, offset, buffer, size) == size);
+            }
 
-    ZipArchive::ZipArchive() = default;
+            /**
+             * @brief Wait for a read to complete. Reads submitted since the last call are passed to the kernel first.
+             * @return The tag of the completed read, and true if all data was read.
+             */
+            std::pair<std::size_t, bool> wait()
+            {
+                if (!m_completed.empty()) {
+                    auto result = m_completed.front();
+                    m_completed.pop_front();
+                    return result;
+                }
 
-    ZipArchive::ZipArchive(const fs::path& fileName)
-    {
-        // ===== If successful, continue to open the file.
-        if (fs::exists(fileName)) open(fileName);
+#ifdef KZIP_IO_URING
+                // ===== Collect the next completion, submitting pending reads and waiting for completions in a single call.
+                while (true) {
+                    auto head = *m_cqHead;
+                    if (head != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE)) {
+                        const auto& completion = m_cqes[head & *m_cqMask];
+                        auto        tag        = static_cast<std::size_t>(completion.user_data);
+                        auto        result     = completion.res;
+                        __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+
+                        // ===== Short or failed reads (e.g. if the kernel doesn't support IORING_OP_READ) are completed
+                        // using a positional read.
+                        auto read = m_reads.extract(tag).mapped();
+                        auto done = static_cast<std::size_t>(std::max(result, 0));
+                        if (done < read.size) done += readFileAt(m_file, read.offset + done, read.buffer + done, read.size - done);
+                        return { tag, done == read.size };
+                    }
+
+                    auto submitted = syscall(__NR_io_uring_enter, m_ring, m_unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    if (submitted < 0 && errno != EINTR) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_FILE_READ_FAILED));
+                    if (submitted > 0) m_unsubmitted -= static_cast<unsigned>(submitted);
+                }
+#else
+                throw ZipLogicError("KZip Error: No reads pending");
+#endif
+            }
 
-        // ===== If unsuccessful, create the archive file and continue.
-        else
-            create(fileName);
-    }
+        private:
+            /**
+             * @brief The Read struct holds a read in flight.
+             */
+            struct Read
+            {
+                uint64_t       offset { 0 };      /**< The position in the file. */
+                unsigned char* buffer = nullptr; /**< The buffer to read into. */
+                std::size_t    size { 0 };        /**< The number of bytes to read. */
+            };
+
+#ifdef KZIP_IO_URING
+            /**
+             * @brief Create the io_uring instance and map its rings. On failure, reads fall back to positional reads.
+             */
+            void setupRing()
+            {
+                io_uring_params params = {};
+                m_ring                 = static_cast<int>(syscall(__NR_io_uring_setup, m_depth, &params));
+                if (m_ring < 0) return;
+
+                m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                m_sqesSize   = params.sq_entries * sizeof(io_uring_sqe);
+                if (params.features & IORING_FEAT_SINGLE_MMAP) m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+
+                auto mapRing = [this](std::size_t size, off_t offset) {
+                    auto* ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, offset);
+                    return ring == MAP_FAILED ? nullptr : static_cast<char*>(ring);
+                };
+                m_sqRing = mapRing(m_sqRingSize, IORING_OFF_SQ_RING);
+                m_cqRing = params.features & IORING_FEAT_SINGLE_MMAP ? m_sqRing : mapRing(m_cqRingSize, IORING_OFF_CQ_RING);
+                m_sqes   = reinterpret_cast<io_uring_sqe*>(mapRing(m_sqesSize, IORING_OFF_SQES));    // NOLINT
+                if (!m_sqRing || !m_cqRing || !m_sqes) {
+                    releaseRing();
+                    return;
+                }
 
-    ZipArchive::ZipArchive(ZipArchive&& other) noexcept = default;
+                m_sqTail  = reinterpret_cast<unsigned*>(m_sqRing + params.sq_off.tail);     // NOLINT
+                m_sqMask  = reinterpret_cast<unsigned*>(m_sqRing + params.sq_off.ring_mask);    // NOLINT
+                m_sqArray = reinterpret_cast<unsigned*>(m_sqRing + params.sq_off.array);    // NOLINT
+                m_cqHead  = reinterpret_cast<unsigned*>(m_cqRing + params.cq_off.head);     // NOLINT
+                m_cqTail  = reinterpret_cast<unsigned*>(m_cqRing + params.cq_off.tail);     // NOLINT
+                m_cqMask  = reinterpret_cast<unsigned*>(m_cqRing + params.cq_off.ring_mask);    // NOLINT
+                m_cqes    = reinterpret_cast<io_uring_cqe*>(m_cqRing + params.cq_off.cqes);    // NOLINT
+            }
 
-    ZipArchive::~ZipArchive() { close(); }
+            /**
+             * @brief Unmap the rings and close the io_uring instance.
+             */
+            void releaseRing()
+            {
+                if (m_sqes) munmap(m_sqes, m_sqesSize);
+                if (m_cqRing && m_cqRing != m_sqRing) munmap(m_cqRing, m_cqRingSize);
+                if (m_sqRing) munmap(m_sqRing, m_sqRingSize);
+                ::close(m_ring);
+                m_ring = -1;
+            }
 
-    ZipArchive& ZipArchive::operator=(ZipArchive&& other) noexcept = default;
+            int           m_ring = -1;            /**< The io_uring file descriptor, or -1 if io_uring isn't used. */
+            char*         m_sqRing = nullptr;     /**< The submission queue ring. */
+            char*         m_cqRing = nullptr;     /**< The completion queue ring. */
+            io_uring_sqe* m_sqes = nullptr;       /**< The submission queue entries. */
+            io_uring_cqe* m_cqes = nullptr;       /**< The completion queue entries. */
+            unsigned*     m_sqTail = nullptr;     /**< The tail of the submission queue. */
+            unsigned*     m_sqMask = nullptr;     /**< The index mask of the submission queue. */
+            unsigned*     m_sqArray = nullptr;    /**< The index array of the submission queue. */
+            unsigned*     m_cqHead = nullptr;     /**< The head of the completion queue. */
+            unsigned*     m_cqTail = nullptr;     /**< The tail of the completion queue. */
+            unsigned*     m_cqMask = nullptr;     /**< The index mask of the completion queue. */
+            std::size_t   m_sqRingSize { 0 };     /**< The mapped size of the submission queue ring. */
+            std::size_t   m_cqRingSize { 0 };     /**< The mapped size of the completion queue ring. */
+            std::size_t   m_sqesSize { 0 };       /**< The mapped size of the submission queue entries. */
+            unsigned      m_unsubmitted { 0 };    /**< The number of entries not yet passed to the kernel. */
+#endif
 
-    void ZipArchive::create(const fs::path& fileName) { m_archive->create(fileName); }
+            std::FILE*                                    m_file = nullptr;   /**< The archive file. */
+            unsigned                                      m_depth { 0 };      /**< The maximum number of reads in flight. */
+            std::unordered_map<std::size_t, Read>         m_reads = {};       /**< The reads in flight, by tag. */
+            std::deque<std::pair<std::size_t, bool>>      m_completed = {};   /**< Reads completed synchronously. */
+        };
 
-    void ZipArchive::open(const fs::path& fileName) { m_archive->open(fileName); }
+        /**
+         * @brief The write callback used by miniz when extracting an entry to a file.
+         */
+        std::size_t writeToStream(void* opaque, mz_uint64 /*offset*/, const void* buffer, std::size_t size)
+        {
+            auto& stream = *static_cast<std::ofstream*>(opaque);
+            stream.write(static_cast<const char*>(buffer), static_cast<std::streamsize>(size));
+            return stream ? size : 0;
+        }
 
-    void ZipArchive::close() { m_archive->close(); }
+        static_assert(std::is_trivially_copyable_v<ZipEntryRecord>, "ZipEntryRecord must be trivially copyable, to be stored in an index file.");
 
-    bool ZipArchive::isOpen() const { return m_archive->isOpen(); }
+        /**
+         * @brief Write the contents of a vector to a binary stream.
+         */
+        template<typename T>
+        void writeVector(std::ostream& stream, const std::vector<T>& data)
+        {
+            stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(T)));    // NOLINT
+        }
 
-    std::vector<std::string> ZipArchive::entryNames(ZipFlags flags) const
-    {
-        return m_archive->entryNames(flags);
-    }
+        /**
+         * @brief Read the given number of elements from a binary stream into a vector.
+         */
+        template<typename T>
+        bool readVector(std::istream& stream, std::vector<T>& data, uint64_t count)
+        {
+            data.resize(count);
+            return static_cast<bool>(stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(count * sizeof(T))));    // NOLINT
+        }
+    }    // namespace
 
-    std::vector<std::string> ZipArchive::entryNames(const std::string& path, ZipFlags flags) const
-    {
-        return m_archive->entryNames(path, flags);
-    }
+    ZipFileMapping::ZipFileMapping(ZipFileMapping&& other) noexcept { *this = std::move(other); }
 
-    uint16_t ZipArchive::entryCount(ZipFlags flags)
+    ZipFileMapping& ZipFileMapping::operator=(ZipFileMapping&& other) noexcept
     {
-        return m_archive->entryCount(flags);
+        if (this == &other) return *this;
+
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+#endif
+
+        return *this;
     }
 
-    uint16_t ZipArchive::entryCount(const std::string& path, ZipFlags flags)
+    ZipFileMapping::~ZipFileMapping() { unmap(); }
+
+    bool ZipFileMapping::map(const fs::path& fileName)
     {
-        return m_archive->entryCount(path, flags);
-    }
+        unmap();
 
-    bool ZipArchive::hasEntry(const std::string& entryName) const { return m_archive->hasEntry(entryName); }
+#ifdef _WIN32
+        auto file = CreateFileW(fileName.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize {};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 ||
+            static_cast<uint64_t>(fileSize.QuadPart) > std::numeric_limits<std::size_t>::max()) {
+            CloseHandle(file);
+            return false;
+        }
+
+        // ===== The mapping object keeps the file open, so the file handle can be closed right away.
+        m_mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!m_mappingHandle) return false;
+
+        auto* data = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (!data) {
+            CloseHandle(m_mappingHandle);
+            m_mappingHandle = nullptr;
+            return false;
+        }
+
+        m_data = static_cast<const std::byte*>(data);
+        m_size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        auto file = ::open(fileName.c_str(), O_RDONLY);    // NOLINT
+        if (file < 0) return false;
+
+        struct stat info {};
+        if (fstat(file, &info) != 0 || info.st_size <= 0 || static_cast<uint64_t>(info.st_size) > std::numeric_limits<std::size_t>::max()) {
+            ::close(file);
+            return false;
+        }
+
+        // ===== The mapping keeps a reference to the file, so the file descriptor can be closed right away.
+        auto* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+        if (data == MAP_FAILED) return false;
+
+        m_data = static_cast<const std::byte*>(data);
+        m_size = static_cast<std::size_t>(info.st_size);
+#endif
+
+        return true;
+    }
+
+    void ZipFileMapping::unmap()
+    {
+        if (!m_data) return;
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mappingHandle);
+        m_mappingHandle = nullptr;
+#else
+        munmap(const_cast<std::byte*>(m_data), m_size);    // NOLINT
+#endif
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    void ZipEntryCache::setCapacity(std::size_t capacity)
+    {
+        m_capacity = capacity;
+        evict(capacity);
+    }
+
+    const std::vector<unsigned char>* ZipEntryCache::find(uint32_t fileIndex)
+    {
+        auto item = m_lookup.find(fileIndex);
+        if (item == m_lookup.end()) {
+            ++m_misses;
+            return nullptr;
+        }
+
+        ++m_hits;
+        m_items.splice(m_items.begin(), m_items, item->second);
+        return &item->second->second;
+    }
+
+    void ZipEntryCache::insert(uint32_t fileIndex, std::vector<unsigned char> data)
+    {
+        erase(fileIndex);
+        if (data.size() > m_capacity) return;
+
+        evict(m_capacity - data.size());
+        m_size += data.size();
+        m_items.emplace_front(fileIndex, std::move(data));
+        m_lookup.emplace(fileIndex, m_items.begin());
+    }
+
+    void ZipEntryCache::erase(uint32_t fileIndex)
+    {
+        auto item = m_lookup.find(fileIndex);
+        if (item == m_lookup.end()) return;
+
+        m_size -= item->second->second.size();
+        m_items.erase(item->second);
+        m_lookup.erase(item);
+    }
+
+    void ZipEntryCache::clear()
+    {
+        m_items.clear();
+        m_lookup.clear();
+        m_size = 0;
+    }
+
+    void ZipEntryCache::resetStatistics()
+    {
+        m_hits   = 0;
+        m_misses = 0;
+    }
+
+    ZipCacheStatistics ZipEntryCache::statistics() const { return { m_hits, m_misses, m_size, m_capacity, m_items.size() }; }
+
+    void ZipEntryCache::evict(std::size_t capacity)
+    {
+        while (m_size > capacity) {
+            m_size -= m_items.back().second.size();
+            m_lookup.erase(m_items.back().first);
+            m_items.pop_back();
+        }
+    }
+
+    std::shared_ptr<const ZipSeekIndex::Checkpoint> ZipSeekIndex::find(uint64_t offset) const
+    {
+        auto item = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), offset, [](uint64_t value, const auto& checkpoint) {
+            return value < checkpoint->outputOffset;
+        });
+
+        return item == m_checkpoints.begin() ? nullptr : *std::prev(item);
+    }
+
+    void ZipSeekIndex::add(std::shared_ptr<const Checkpoint> checkpoint)
+    {
+        if (checkpoint->outputOffset >= nextOffset()) m_checkpoints.push_back(std::move(checkpoint));
+    }
+
+    void ZipEntryIndex::insert(std::string_view name, std::size_t slot) { insertHash(hashOf(name), slot); }
+
+    void ZipEntryIndex::insertHash(std::size_t hash, std::size_t slot)
+    {
+        // ===== Keep the load factor at or below 50%, to keep the probe sequences short.
+        if ((m_size + 1) * 2 > m_buckets.size()) rehash(std::max<std::size_t>(16, m_buckets.size() * 2));
+
+        auto mask = m_buckets.size() - 1;
+        auto pos  = hash & mask;
+        while (m_buckets[pos].slot != npos) pos = (pos + 1) & mask;
+
+        m_buckets[pos] = { hash, slot };
+        ++m_size;
+    }
+
+    void ZipEntryIndex::reserve(std::size_t count)
+    {
+        auto bucketCount = std::size_t { 16 };
+        while (bucketCount < count * 2) bucketCount *= 2;
+        if (bucketCount > m_buckets.size()) rehash(bucketCount);
+    }
+
+    void ZipEntryIndex::clear()
+    {
+        m_buckets.clear();
+        m_size = 0;
+    }
+
+    std::size_t ZipEntryIndex::size() const { return m_size; }
+
+    void ZipEntryIndex::write(std::ostream& stream) const
+    {
+        // ===== The hash of a fixed string is written first, so that an index written with another hash function isn't used.
+        uint64_t header[3] = { hashOf("KZip"), m_size, m_buckets.size() };
+        stream.write(reinterpret_cast<const char*>(header), sizeof header);    // NOLINT
+        writeVector(stream, m_buckets);
+    }
+
+    bool ZipEntryIndex::read(std::istream& stream, std::size_t slotCount, uint64_t available)
+    {
+        uint64_t header[3] = {};
+        if (available < sizeof header) return false;
+        if (!stream.read(reinterpret_cast<char*>(header), sizeof header) || header[0] != hashOf("KZip")) return false;    // NOLINT
+        if (header[2] == 0 || (header[2] & (header[2] - 1)) || header[2] > (available - sizeof header) / sizeof(Bucket)) return false;
+        if (!readVector(stream, m_buckets, header[2])) return false;
+
+        // ===== Every occupied bucket must refer to a slot in the entry table, and at least one bucket must be empty, as
+        // that ends the probe sequence of a lookup.
+        std::size_t occupied = 0;
+        for (const auto& bucket : m_buckets) {
+            if (bucket.slot == npos) continue;
+            if (bucket.slot >= slotCount) return false;
+            ++occupied;
+        }
+        if (occupied != header[1] || occupied >= m_buckets.size()) return false;
+
+        m_size = occupied;
+        return true;
+    }
+
+    void ZipEntryIndex::eraseBucket(std::size_t pos)
+    {
+        // ===== Backward-shift deletion: move subsequent buckets in the probe sequence into the hole, so that no
+        // tombstones are required in the index.
+        auto mask = m_buckets.size() - 1;
+        auto hole = pos;
+        for (auto next = (hole + 1) & mask; m_buckets[next].slot != npos; next = (next + 1) & mask) {
+            auto home = m_buckets[next].hash & mask;
+
+            // ===== A bucket may only be moved to the hole if the hole lies cyclically between its home and its position.
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                m_buckets[hole] = m_buckets[next];
+                hole            = next;
+            }
+        }
+
+        m_buckets[hole] = Bucket();
+        --m_size;
+    }
+
+    void ZipEntryIndex::rehash(std::size_t bucketCount)
+    {
+        std::vector<Bucket> buckets(bucketCount);
+        auto                mask = bucketCount - 1;
+
+        for (const auto& bucket : m_buckets) {
+            if (bucket.slot == npos) continue;
+            auto pos = bucket.hash & mask;
+            while (buckets[pos].slot != npos) pos = (pos + 1) & mask;
+            buckets[pos] = bucket;
+        }
+
+        m_buckets = std::move(buckets);
+    }
+
+    ZipGlob::ZipGlob(std::string_view pattern)
+    {
+        // ===== The literal prefix is used for looking up the range of candidate names in the sorted name index.
+        m_literalPrefix = std::string(pattern.substr(0, pattern.find_first_of("*?[\\")));
+
+        // ===== Split the pattern into segments.
+        for (std::size_t position = 0; position <= pattern.size();) {
+            auto end     = std::min(pattern.find('/', position), pattern.size());
+            auto segment = Segment();
+
+            segment.pattern    = std::string(pattern.substr(position, end - position));
+            segment.isLiteral  = segment.pattern.find_first_of("*?[\\") == std::string::npos;
+            segment.isGlobstar = segment.pattern == "**";
+            m_segments.push_back(std::move(segment));
+
+            position = end + 1;
+        }
+
+        while (m_fixedCount < m_segments.size() && !m_segments[m_fixedCount].isGlobstar) ++m_fixedCount;
+    }
+
+    const std::string& ZipGlob::literalPrefix() const { return m_literalPrefix; }
+
+    ZipGlob::Result ZipGlob::match(std::string_view name) const
+    {
+        // ===== Match the segments before the first '**' one by one. The position is past the end of the name, when all
+        // segments of the name have been consumed.
+        std::size_t position = 0;
+        for (std::size_t i = 0; i < m_fixedCount; ++i) {
+            if (position > name.size()) return {};
+
+            auto end = std::min(name.find('/', position), name.size());
+            if (!matchSegment(m_segments[i], name.substr(position, end - position)))
+                return { false, end < name.size() ? end + 1 : 0 };
+
+            position = end + 1;
+        }
+
+        // ===== If there is no '**' in the pattern, names with more segments than the pattern can't match, and neither
+        // can any other names in the same folder.
+        if (m_fixedCount == m_segments.size()) {
+            if (position > name.size()) return { true, 0 };
+            return { false, position };
+        }
+
+        return { matchFrom(m_fixedCount, name, position), 0 };
+    }
+
+    bool ZipGlob::matchFrom(std::size_t segment, std::string_view name, std::size_t position) const
+    {
+        if (segment == m_segments.size()) return position > name.size();
+
+        // ===== A '**' segment matches any number of segments; try each of them, starting with none.
+        if (m_segments[segment].isGlobstar) {
+            while (true) {
+                if (matchFrom(segment + 1, name, position)) return true;
+                if (position > name.size()) return false;
+                position = std::min(name.find('/', position), name.size()) + 1;
+            }
+        }
+
+        if (position > name.size()) return false;
+        auto end = std::min(name.find('/', position), name.size());
+        return matchSegment(m_segments[segment], name.substr(position, end - position)) && matchFrom(segment + 1, name, end + 1);
+    }
+
+    bool ZipGlob::matchSegment(const Segment& segment, std::string_view text)
+    {
+        if (segment.isLiteral) return segment.pattern == text;
+
+        // ===== Match with backtracking to the most recent '*', which is sufficient, as '*' can match anything.
+        std::string_view pattern  = segment.pattern;
+        std::size_t      p        = 0;
+        std::size_t      t        = 0;
+        std::size_t      starP    = std::string_view::npos;
+        std::size_t      starT    = 0;
+        while (t < text.size()) {
+            if (p < pattern.size() && pattern[p] == '*') {
+                starP = p++;
+                starT = t;
+                continue;
+            }
+
+            auto next = p < pattern.size() ? matchCharacter(pattern, p, text[t]) : std::string_view::npos;
+            if (next != std::string_view::npos) {
+                p = next;
+                ++t;
+            }
+            else if (starP != std::string_view::npos) {
+                p = starP + 1;
+                t = ++starT;
+            }
+            else
+                return false;
+        }
+
+        while (p < pattern.size() && pattern[p] == '*') ++p;
+        return p == pattern.size();
+    }
+
+    std::size_t ZipGlob::matchCharacter(std::string_view pattern, std::size_t position, char character)
+    {
+        switch (pattern[position]) {
+            case '?':
+                return position + 1;
+
+            case '\\':
+                if (position + 1 < pattern.size()) return pattern[position + 1] == character ? position + 2 : std::string_view::npos;
+                break;
+
+            case '[': {
+                // ===== Find the end of the set. A ']' immediately after the opening bracket is part of the set. If
+                // there is no closing bracket, the '[' is treated as a literal character.
+                auto first  = position + 1;
+                auto negate = first < pattern.size() && (pattern[first] == '!' || pattern[first] == '^');
+                if (negate) ++first;
+                auto last = pattern.find(']', first < pattern.size() && pattern[first] == ']' ? first + 1 : first);
+                if (last == std::string_view::npos) break;
+
+                auto found = false;
+                for (auto i = first; i < last && !found; ++i) {
+                    if (i + 2 < last && pattern[i + 1] == '-') {
+                        found = pattern[i] <= character && character <= pattern[i + 2];
+                        i += 2;
+                    }
+                    else
+                        found = pattern[i] == character;
+                }
+
+                return found != negate ? last + 1 : std::string_view::npos;
+            }
+
+            default:
+                break;
+        }
+
+        return pattern[position] == character ? position + 1 : std::string_view::npos;
+    }
+
+    ZipArchive::ZipArchive() = default;
+
+    ZipArchive::ZipArchive(ZipArchive&& other) noexcept = default;
+
+    ZipArchive::~ZipArchive() { close(); }
+
+    ZipArchive& ZipArchive::operator=(ZipArchive&& other) = default;
+
+    void ZipArchive::create(const fs::path& fileName)
+    {
+        // ===== Prepare an archive file;
+        mz_zip_archive archive = mz_zip_archive();
+        mz_zip_writer_init_file(&archive, fileName.string().c_str(), 0);
+
+        // ===== Finalize and close the temporary archive
+        mz_zip_writer_finalize_archive(&archive);
+        mz_zip_writer_end(&archive);
+
+        // ===== Validate the temporary file
+        mz_zip_error errordata { mz_zip_error() };
+        if (!mz_zip_validate_file_archive(fileName.string().c_str(), 0, &errordata)) {
+            throw ZipRuntimeError(mz_zip_get_error_string(errordata));
+        }
+
+        // ===== If everything is OK, open the newly created archive.
+        open(fileName, m_openMode);
+    }
+
+    void ZipArchive::open(const fs::path& fileName, OpenMode mode, std::size_t threadCount)
+    {
+        if (isOpen()) close();
+        m_openMode    = mode;
+        m_threadCount = threadCount > 0 ? threadCount : std::max(1U, std::thread::hardware_concurrency());
+        m_mutex       = static_cast<bool>(mode & OpenMode::Concurrent) ? std::make_unique<std::mutex>() : nullptr;
+
+        // ===== Open the zip archive file. If unsuccessful, throw exception. Entries are looked up using the name index
+        // of this class, so miniz doesn't need to sort the central directory (which is slow for large archives).
+        // In memory mapped mode, miniz reads from the mapping using memcpy; if the file can't be mapped, it is read as usual.
+        m_archivePath = fileName;
+        auto isMapped = static_cast<bool>(mode & OpenMode::MemoryMapped) && m_mapping.map(m_archivePath);
+        auto isOpened = isMapped ? mz_zip_reader_init_mem(&m_archive, m_mapping.data(), m_mapping.size(), MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY)
+                                 : mz_zip_reader_init_file(&m_archive, m_archivePath.string().c_str(), MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY);
+        if (!isOpened) {
+            m_mapping.unmap();
+            throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
+        }
+        m_isOpen = true;
+
+        // ===== In concurrent mode, the archive file is read using positional reads, so that threads reading different
+        // entries don't share a file position. This is not required for memory mapped archives, which are read using memcpy.
+        if (m_mutex && !isMapped) m_archive.m_pRead = readAt;
+
+        // ===== If an up-to-date index file exists, the tables are loaded from there.
+        auto isIndexed = static_cast<bool>(mode & OpenMode::Indexed);
+        if (isIndexed && readIndexFile()) return;
+
+        // ===== Decode the central directory into the entry table. In lazy mode, only the file index and the name are
+        // registered; the remaining metadata is read when the entry is first accessed. For large archives, the central
+        // directory is split into chunks that are decoded in parallel, each with its own name arena.
+        auto fileCount = mz_zip_reader_get_num_files(&m_archive);
+        auto isLazy    = static_cast<bool>(mode & OpenMode::Lazy);
+        auto arenas    = std::vector<std::string>(chunkCount(fileCount, m_threadCount, MinEntriesPerThread));
+        m_entries.resize(fileCount);
+        parallelFor(fileCount, m_threadCount, MinEntriesPerThread, [&](std::size_t first, std::size_t last, std::size_t chunk) {
+            auto& arena = arenas[chunk];
+            auto  cache = DosTimeCache();
+            for (auto i = static_cast<uint32_t>(first); i < last; ++i) {
+                auto& record       = m_entries[i];
+                record.fileIndex   = i;
+                record.isInArchive = true;
+
+                std::string_view name;
+                if (isLazy) {
+                    record.isLoaded    = false;
+                    record.isDirectory = mz_zip_reader_is_file_a_directory(&m_archive, i);
+                    name               = centralDirName(i);
+                }
+                else {
+                    decodeStats(record, m_archive, i, cache);
+                    name = centralDirName(i);
+                }
+
+                record.nameOffset = arena.size();
+                record.nameLength = static_cast<uint32_t>(name.size());
+                arena.append(name.data(), name.size());
+                arena.push_back('\0');
+            }
+        });
+        if (fileCount > m_currentIndex) m_currentIndex = fileCount - 1;
+
+        // ===== Concatenate the name arenas, and compute the hashes of the names while relocating them.
+        auto arenaOffsets = std::vector<std::size_t>(arenas.size());
+        for (std::size_t chunk = 0; chunk < arenas.size(); ++chunk) {
+            arenaOffsets[chunk] = m_nameArena.size();
+            if (chunk == 0) m_nameArena = std::move(arenas[chunk]);
+            else
+                m_nameArena.append(arenas[chunk]);
+            std::string().swap(arenas[chunk]);
+        }
+
+        auto hashes = std::vector<std::size_t>(fileCount);
+        parallelFor(fileCount, m_threadCount, MinEntriesPerThread, [&](std::size_t first, std::size_t last, std::size_t chunk) {
+            for (auto slot = first; slot < last; ++slot) {
+                m_entries[slot].nameOffset += arenaOffsets[chunk];
+                hashes[slot] = ZipEntryIndex::hashOf(entryName(slot));
+            }
+        });
+
+        m_proxies.resize(m_entries.size());
+
+        // ===== Build the name index in a single pass. If a name occurs more than once (e.g. in an archive that has been
+        // appended to), the newest entry is retained, and the entries it shadows are left in the table as deleted entries.
+        // That way, they will neither be listed nor written when saving the archive.
+        m_entryIndex.reserve(m_entries.size());
+        for (std::size_t slot = 0; slot < m_entries.size(); ++slot) {
+            auto shadowed = m_entryIndex.assign(entryName(slot), hashes[slot], slot, [this](std::size_t i) { return entryName(i); });
+            if (shadowed != ZipEntryIndex::npos) {
+                m_entries[shadowed].isDeleted = true;
+                ++m_shadowedCount;
+            }
+        }
+
+        // ===== Add folder entries if they don't exist. The deleted entries are accounted for afterwards, so that the
+        // entry table will not be compacted while iterating through it.
+        for (std::size_t slot = 0, count = m_entries.size(); slot < count; ++slot)
+            if (!m_entries[slot].isDeleted) registerParentFolders(entryName(slot));
+        m_deletedCount = m_shadowedCount;
+
+        // ===== Build the sorted name index used for prefix queries. In lazy mode, this is deferred to the first query.
+        if (static_cast<bool>(mode & OpenMode::Lazy)) {
+            m_pendingSlots.resize(m_entries.size());
+            std::iota(m_pendingSlots.begin(), m_pendingSlots.end(), std::size_t { 0 });
+        }
+        else
+            rebuildSortedIndex();
+
+        if (isIndexed) writeIndexFile();
+    }
+
+    ZipEntryProxy& ZipArchive::addEntry(const std::string& path)
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: addEntry(). Archive is invalid or not open!");
+
+        // ===== Ensure that all folders and subfolders in the path name have an entry in the archive
+        registerParentFolders(path);
+
+        // ===== If an entry with the given name already exists in the archive, overwrite it. Otherwise, create a new entry.
+        auto slot = findEntry(path);
+        if (slot != ZipEntryIndex::npos) {
+            // ===== The existing entry is reset in place (keeping the name), so that references to its ZipEntryProxy object
+            // remain valid.
+            uncache(slot);
+            auto record       = createRecord(path);
+            record.nameOffset = m_entries[slot].nameOffset;
+            record.nameLength = m_entries[slot].nameLength;
+            m_entries[slot]   = record;
+            if (m_proxies[slot]) m_proxies[slot]->m_data.reset();
+            return proxy(slot);
+        }
+
+        return proxy(appendEntry(createRecord(path), path));
+    }
+
+    void ZipArchive::reserveEntries(std::size_t count)
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: reserveEntries(). Archive is invalid or not open!");
+
+        auto size = m_entries.size() - m_deletedCount + count;
+        m_entries.reserve(size);
+        m_proxies.reserve(size);
+        m_entryIndex.reserve(size);
+    }
+
+    void ZipArchive::deleteEntry(const std::string& name)
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: deleteEntry(). Archive is invalid or not open!");
+
+        // ===== The entry is left in the table as a tombstone. When saving, only the live entries will be saved or copied
+        // from the original file.
+        auto slot = findEntry(name);
+        if (slot == ZipEntryIndex::npos) return;
+
+        uncache(slot);
+        m_entryIndex.erase(name, [this](std::size_t i) { return entryName(i); });
+        m_entries[slot].isDeleted = true;
+        ++m_deletedCount;
+    }
+
+    ZipEntryProxy& ZipArchive::entry(const std::string& path)
+    {
+        if (!isOpen()) throw ZipLogicError("Cannot get entry from empty ZipArchive object!");
+
+        // ===== Look up the entry in the name index.
+        auto slot = findEntry(path);
+        if (slot == ZipEntryIndex::npos) throw ZipLogicError("KZip Error: Entry '" + path + "' does not exist");
+
+        return proxy(slot);
+    }
+
+    const ZipEntryProxy& ZipArchive::entry(const std::string& path) const
+    {
+        if (!isOpen()) throw ZipLogicError("Cannot get entry from empty ZipArchive object!");
+
+        // ===== Look up the entry in the name index.
+        auto slot = findEntry(path);
+        if (slot == ZipEntryIndex::npos) throw ZipLogicError("KZip Error: Entry '" + path + "' does not exist");
+
+        return proxy(slot);
+    }
+
+    std::vector<std::string> ZipArchive::entryNames(ZipFlags flags) const
+    {
+        return entryNames("", flags);
+    }
+
+    std::vector<std::string> ZipArchive::entryNames(const std::string& path, ZipFlags flags) const
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: entryNames(). Archive is invalid or not open!");
+
+        std::vector<std::string> result;
+        for (const auto& item : entries(path, flags)) result.emplace_back(item.name());
+
+        return result;
+    }
+
+    uint64_t ZipArchive::entryCount(ZipFlags flags) const {
+        return entryCount("", flags);
+    }
+
+    uint64_t ZipArchive::entryCount(const std::string& path, ZipFlags flags) const {
+        if (!isOpen()) throw ZipLogicError("Function call: entryCount(). Archive is invalid or not open!");
+
+        auto range = entries(path, flags);
+        return static_cast<uint64_t>(std::distance(range.begin(), range.end()));
+    }
+
+    ZipEntryRange ZipArchive::entries(std::string_view path, ZipFlags flags) const
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: entries(). Archive is invalid or not open!");
+
+        // ===== The iterators only read from the archive, but the entries they yield give access to the ZipEntryProxy objects.
+        auto* archive = const_cast<ZipArchive*>(this);    // NOLINT
+
+        // ===== Without a path, visit all entries in archive order.
+        if (path.empty())
+            return { ZipEntryIterator(archive, nullptr, 0, m_entries.size(), flags),
+                     ZipEntryIterator(archive, nullptr, m_entries.size(), m_entries.size(), flags) };
+
+        // ===== Otherwise, only visit the entries in the sorted index that have the path as prefix.
+        auto [first, last] = prefixRange(path);
+        auto begin         = static_cast<std::size_t>(first - m_sortedSlots.cbegin());
+        auto end           = static_cast<std::size_t>(last - m_sortedSlots.cbegin());
+
+        return { ZipEntryIterator(archive, m_sortedSlots.data(), begin, end, flags),
+                 ZipEntryIterator(archive, m_sortedSlots.data(), end, end, flags) };
+    }
+
+    ZipEntryRange ZipArchive::find(std::string_view pattern, ZipFlags flags) const
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: find(). Archive is invalid or not open!");
+
+        // ===== Only the entries in the sorted index that have the literal prefix of the pattern can match.
+        auto* archive      = const_cast<ZipArchive*>(this);    // NOLINT
+        auto  glob         = std::make_shared<const ZipGlob>(pattern);
+        auto [first, last] = prefixRange(glob->literalPrefix());
+        auto begin         = static_cast<std::size_t>(first - m_sortedSlots.cbegin());
+        auto end           = static_cast<std::size_t>(last - m_sortedSlots.cbegin());
+
+        return { ZipEntryIterator(archive, m_sortedSlots.data(), begin, end, flags, glob),
+                 ZipEntryIterator(archive, m_sortedSlots.data(), end, end, flags, glob) };
+    }
+
+    bool ZipArchive::hasEntry(const std::string& entryName) const
+    {
+        if (!isOpen()) throw ZipLogicError("Cannot call HasEntry on empty ZipArchive object!");
+
+        return findEntry(entryName) != ZipEntryIndex::npos;
+    }
+
+    uint64_t ZipArchive::shadowedEntryCount() const { return m_shadowedCount; }
+
+    void ZipArchive::setCacheSize(std::size_t capacity)
+    {
+        auto guard = lock();
+        m_cache.setCapacity(capacity);
+    }
+
+    ZipCacheStatistics ZipArchive::cacheStatistics() const
+    {
+        auto guard = lock();
+        return m_cache.statistics();
+    }
+
+    void ZipArchive::setSeekInterval(uint64_t interval)
+    {
+        if (interval == 0) throw ZipLogicError("KZip Error: The seek interval must be positive");
+        m_seekInterval = interval;
+    }
+
+    void ZipArchive::setVerification(ZipVerification verification)
+    {
+        m_verification = verification == ZipVerification::Default ? ZipVerification::Always : verification;
+    }
+
+    ZipVerification ZipArchive::verification() const { return m_verification; }
+
+    void ZipArchive::setInflateEngine(ZipInflateEngine engine) { m_inflateEngine = engine; }
+
+    ZipInflateEngine ZipArchive::inflateEngine() const { return m_inflateEngine; }
+
+    void ZipArchive::clearCache()
+    {
+        auto guard = lock();
+        m_seekIndexes.clear();
+        m_cache.clear();
+        m_cache.resetStatistics();
+    }
+
+    void ZipArchive::close()
+    {
+        waitForExtractions();
+        if (isOpen()) {
+            mz_zip_reader_end(&m_archive);
+        }
+        m_mapping.unmap();
+        m_cache.clear();
+        m_seekIndexes.clear();
+        m_entries.clear();
+        m_proxies.clear();
+        m_nameArena.clear();
+        m_entryIndex.clear();
+        m_sortedSlots.clear();
+        m_pendingSlots.clear();
+        m_deletedCount  = 0;
+        m_shadowedCount = 0;
+        m_archivePath.clear();
+        m_isOpen = false;
+    }
+
+    bool ZipArchive::isOpen() const { return m_isOpen; }
+
+    void ZipArchive::save(fs::path filename)
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: save(). Archive is invalid or not open!");
+        waitForExtractions();
+
+        if (filename.empty()) {
+            filename = m_archivePath;
+        }
+
+        // ===== Lambda function for generating a gandom filename
+        auto generateRandomName = []() {
+            static const std::string letters = "abcdefghijklmnopqrstuvwxyz0123456789";
+
+            std::random_device                          rand_dev;
+            std::mt19937                                generator(rand_dev());
+            std::uniform_int_distribution<unsigned int> distr(0, letters.size() - 1);
+
+            std::string result = ".~$";
+            for (int i = 0; i < 12; ++i) {    // NOLINT
+                result += letters[distr(generator)];
+            }
+
+            return result + ".tmp";
+        };
+
+        // ===== Generate a random file name with the same path as the current file
+        fs::path tempPath = filename.parent_path() /= generateRandomName();
+
+        // ===== Determine if the archive must be written in the zip64 format, i.e. if it will hold more than 65535 entries
+        // or more than 4 GB of data. Entries in a zip64 archive can only be copied to a zip64 archive.
+        auto totalSize = uint64_t { m_archive.m_archive_size };
+        for (const auto& item : m_proxies)
+            if (item && item->isUpdated()) totalSize += item->rawData().size();
+        auto isZip64 = m_archive.m_pState->m_zip64 || m_entries.size() - m_deletedCount >= MZ_UINT16_MAX || totalSize >= MZ_UINT32_MAX;
+
+        // ===== Prepare an temporary archive file with the random filename;
+        mz_zip_archive tempArchive = mz_zip_archive();
+        mz_zip_writer_init_file_v2(&tempArchive, tempPath.string().c_str(), 0, isZip64 ? MZ_ZIP_FLAG_WRITE_ZIP64 : 0);
+
+        // ===== Iterate through the ZipEntries and add entries to the temporary file
+        for (std::size_t slot = 0; slot < m_entries.size(); ++slot) {
+            const auto& record = m_entries[slot];
+            if (record.isDeleted || record.isDirectory) continue;
+
+            // ===== Entries with new data are written from memory. The names in the name arena are null-terminated, so
+            // they can be passed directly to miniz.
+            const auto* item = m_proxies[slot].get();
+            if (item && item->isUpdated()) {
+                if (!mz_zip_writer_add_mem(&tempArchive,
+                                           entryName(slot).data(),
+                                           item->rawData().data(),
+                                           item->rawData().size(),
+                                           MZ_DEFAULT_COMPRESSION))
+                {
+                    throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
+                }
+            }
+
+            // ===== Unmodified entries are copied directly from the original archive. miniz copies the name from the original
+            // archive as well, so renamed entries are copied by writing their compressed data under the new name.
+            else if (record.isInArchive && entryName(slot) == centralDirName(record.fileIndex)) {
+                if (!mz_zip_writer_add_from_zip_reader(&tempArchive, &m_archive, record.fileIndex)) {
+                    throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
+                }
+            }
+            else if (record.isInArchive) {
+                if (record.method != 0 && record.method != MZ_DEFLATED) {
+                    throw ZipRuntimeError("KZip Error: Entry '" + std::string(entryName(slot)) + "' uses an unsupported compression method and can't be renamed");
+                }
+
+                // ===== Stored data is added uncompressed, which recomputes the checksum; deflated data is added as is.
+                auto data       = compressedData(slot);
+                auto time       = static_cast<MZ_TIME_T>(record.time);
+                auto isDeflated = record.method == MZ_DEFLATED;
+                if (!mz_zip_writer_add_mem_ex_v2(&tempArchive,
+                                                 entryName(slot).data(),
+                                                 data.data(),
+                                                 data.size(),
+                                                 nullptr,
+                                                 0,
+                                                 isDeflated ? mz_uint { MZ_ZIP_FLAG_COMPRESSED_DATA } : mz_uint { MZ_NO_COMPRESSION },
+                                                 isDeflated ? data.uncompressedSize() : 0,
+                                                 data.crc32(),
+                                                 &time,
+                                                 nullptr,
+                                                 0,
+                                                 nullptr,
+                                                 0))
+                {
+                    throw ZipRuntimeError(mz_zip_get_error_string(tempArchive.m_last_error));
+                }
+            }
+
+            // ===== New entries that have not been given any data are written as empty entries.
+            else {
+                if (!mz_zip_writer_add_mem(&tempArchive, entryName(slot).data(), nullptr, 0, MZ_DEFAULT_COMPRESSION)) {
+                    throw ZipRuntimeError(mz_zip_get_error_string(m_archive.m_last_error));
+                }
+            }
+        }
+
+        // ===== Finalize and close the temporary archive
+        mz_zip_writer_finalize_archive(&tempArchive);
+        mz_zip_writer_end(&tempArchive);
+
+        // ===== Validate the temporary file. miniz writes 32-bit data descriptors for small entries, also in zip64
+        // archives, but the validation expects 64-bit descriptors for all entries in a zip64 archive. Hence, for zip64
+        // archives, it is only validated that the central directory can be read.
+        mz_zip_error errordata = {};
+        if (isZip64) {
+            mz_zip_archive validationArchive = mz_zip_archive();
+            if (!mz_zip_reader_init_file(&validationArchive, tempPath.string().c_str(), MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY)) {
+                throw ZipRuntimeError(mz_zip_get_error_string(validationArchive.m_last_error));
+            }
+            mz_zip_reader_end(&validationArchive);
+        }
+        else if (!mz_zip_validate_file_archive(tempPath.string().c_str(), 0, &errordata)) {
+            throw ZipRuntimeError(mz_zip_get_error_string(errordata));
+        }
+
+        // ===== Close the current archive, delete the file with input filename (if it exists), rename the temporary and call Open.
+        close();
+        nowide::remove(filename.string().c_str());                      // NOLINT
+        nowide::rename(tempPath.string().c_str(), filename.string().c_str());    // NOLINT
+        open(filename, m_openMode, m_threadCount);
+    }
+
+    void ZipArchive::extractAll(const fs::path& directory, const ZipExtractOptions& options) const
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: extractAll(). Archive is invalid or not open!");
+
+        // ===== Check all names before anything is written, so that no entry can be extracted outside the target
+        // directory (e.g. through names like '../file' or '/etc/file').
+        std::vector<std::size_t> files;
+        std::vector<std::size_t> folders;
+        for (std::size_t slot = 0; slot < m_entries.size(); ++slot) {
+            if (m_entries[slot].isDeleted) continue;
+
+            auto path = fs::u8path(entryName(slot));
+            if (path.has_root_path() || std::any_of(path.begin(), path.end(), [](const fs::path& part) { return part == ".."; })) {
+                throw ZipRuntimeError("KZip Error: Entry '" + std::string(entryName(slot)) + "' would be extracted outside the target directory");
+            }
+
+            (record(slot).isDirectory ? folders : files).push_back(slot);
+        }
+
+        // ===== Create the folders up front (the parent folders of all files are registered as folder entries), so the
+        // workers only have to write files.
+        fs::create_directories(directory);
+        for (auto slot : folders) fs::create_directories(directory / fs::u8path(entryName(slot)));
+
+        // ===== Extract the largest files first. As each worker takes the next file when it is done with the previous
+        // one, the workers then finish at about the same time.
+        auto sizeOf = [this](std::size_t slot) {
+            const auto* item = updatedProxy(slot);
+            return item ? item->rawData().size() : m_entries[slot].uncompressedSize;
+        };
+        std::stable_sort(files.begin(), files.end(), [&](std::size_t a, std::size_t b) { return sizeOf(a) > sizeOf(b); });
+
+        auto threadCount = options.threadCount > 0 ? options.threadCount : std::max(1U, std::thread::hardware_concurrency());
+        auto workerCount = std::min(threadCount, files.size());
+        auto next        = std::atomic<std::size_t> { 0 };
+        auto isFailed    = std::atomic<bool> { false };
+        parallelFor(workerCount, workerCount, 1, [&](std::size_t, std::size_t, std::size_t) {
+            auto reader = WorkerReader(m_archivePath, m_mapping);
+            for (auto i = next++; i < files.size() && !isFailed; i = next++) {
+                auto slot = files[i];
+                auto path = directory / fs::u8path(entryName(slot));
+                if (!options.overwrite && fs::exists(path)) continue;
+
+                try {
+                    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+                    if (!stream) throw ZipRuntimeError("KZip Error: Unable to create file '" + path.string() + "'");
+
+                    // ===== New and modified entries are written from memory; entries without data are written as empty files.
+                    const auto* item = updatedProxy(slot);
+                    if (item) {
+                        stream.write(reinterpret_cast<const char*>(item->rawData().data()), static_cast<std::streamsize>(item->rawData().size()));    // NOLINT
+                    }
+                    else if (m_entries[slot].isInArchive) {
+                        auto& archive  = reader.archive();
+                        auto  isVerify = isVerifying(slot, ZipVerification::Default);
+                        auto  flags    = isVerify ? 0 : mz_uint { MZ_ZIP_FLAG_SKIP_CRC32_CHECK };
+                        if (!mz_zip_reader_extract_to_callback(&archive, m_entries[slot].fileIndex, writeToStream, &stream, flags)) {
+                            throw ZipRuntimeError(mz_zip_get_error_string(archive.m_last_error));
+                        }
+                        if (isVerify) setVerified(slot);
+                    }
+
+                    stream.close();
+                    if (!stream) throw ZipRuntimeError("KZip Error: Unable to write file '" + path.string() + "'");
+                }
+                catch (...) {
+                    isFailed = true;
+                    throw;
+                }
+            }
+        });
+    }
+
+    void ZipArchive::extract(const std::vector<std::string>& names, const ZipEntrySink& sink) const
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: extract(). Archive is invalid or not open!");
+
+        // ===== Look up all entries before anything is extracted, and sort them by the position in the archive file.
+        std::vector<std::pair<uint64_t, std::size_t>> requests;
+        requests.reserve(names.size());
+        for (const auto& name : names) {
+            auto slot = findEntry(name);
+            if (slot == ZipEntryIndex::npos) throw ZipLogicError("KZip Error: Entry '" + name + "' does not exist");
+            requests.emplace_back(record(slot).localHeaderOffset, slot);
+        }
+        std::sort(requests.begin(), requests.end());
+
+        auto& archive   = const_cast<mz_zip_archive&>(m_archive);    // NOLINT
+        auto  isBatched = [this](std::size_t slot) { return !updatedProxy(slot) && record(slot).isInArchive; };
+        auto  endOf     = [&archive](const ZipEntryRecord& info) { return estimatedEnd(info, archive.m_archive_size); };
+
+        // ===== New and modified entries, and entries that don't fit in a batch, are read one by one.
+        std::vector<unsigned char> data;
+        auto                       readSingle = [&](std::size_t slot) {
+            proxy(slot).readInto(data);
+            sink(entryName(slot), data);
+        };
+
+        std::vector<unsigned char> buffer;
+        for (std::size_t first = 0, last = 0; first < requests.size(); first = last) {
+            auto        slot = requests[first].second;
+            const auto& info = record(slot);
+            last             = first + 1;
+            if (!isBatched(slot) || endOf(info) - info.localHeaderOffset > MaxBatchSize) {
+                readSingle(slot);
+                continue;
+            }
+
+            // ===== Extend the batch with the following entries, as long as they are close to the previous ones.
+            auto batchOffset = info.localHeaderOffset;
+            auto batchEnd    = endOf(info);
+            for (; last < requests.size() && isBatched(requests[last].second); ++last) {
+                const auto& next = record(requests[last].second);
+                if (next.localHeaderOffset > batchEnd + MaxBatchGap || endOf(next) - batchOffset > MaxBatchSize) break;
+                batchEnd = std::max(batchEnd, endOf(next));
+            }
+
+            // ===== Memory mapped archives are decompressed in place; otherwise, the batch is read with a single read.
+            auto        batchSize = batchEnd - batchOffset;
+            const auto* batch     = static_cast<const unsigned char*>(archive.m_pState->m_pMem);
+            if (batch)
+                batch += batchOffset;
+            else {
+                buffer.resize(static_cast<std::size_t>(batchSize));
+                if (archive.m_pRead(archive.m_pIO_opaque, batchOffset, buffer.data(), buffer.size()) != buffer.size()) {
+                    throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_FILE_READ_FAILED));
+                }
+                batch = buffer.data();
+            }
+
+            for (auto i = first; i < last; ++i) {
+                auto item     = requests[i].second;
+                auto position = record(item).localHeaderOffset - batchOffset;
+                if (inflateEntry(item, batch + position, batchSize - position, data))
+                    sink(entryName(item), data);
+                else
+                    readSingle(item);
+            }
+        }
+    }
+
+    std::future<void> ZipArchive::extractAsync(const std::vector<std::string>& names, ZipEntrySink sink, std::size_t threadCount) const
+    {
+        if (!isOpen()) throw ZipLogicError("Function call: extractAsync(). Archive is invalid or not open!");
+
+        // ===== Look up all entries (and load their metadata) up front, so that errors are reported to the caller, and
+        // sort them by the position in the archive file.
+        std::vector<std::pair<uint64_t, std::size_t>> requests;
+        requests.reserve(names.size());
+        for (const auto& name : names) {
+            auto slot = findEntry(name);
+            if (slot == ZipEntryIndex::npos) throw ZipLogicError("KZip Error: Entry '" + name + "' does not exist");
+            requests.emplace_back(record(slot).localHeaderOffset, slot);
+        }
+        std::sort(requests.begin(), requests.end());
+
+        // ===== The extraction is counted until it finishes, so that close() and save() can wait for it. The count is
+        // released while holding the lock, as the archive may be destroyed as soon as the lock is released.
+        auto* extractions = m_extractions.get();
+        {
+            std::lock_guard<std::mutex> guard(extractions->mutex);
+            ++extractions->count;
+        }
+        auto release = [extractions]() {
+            std::lock_guard<std::mutex> guard(extractions->mutex);
+            --extractions->count;
+            extractions->finished.notify_all();
+        };
+
+        try {
+            return std::async(std::launch::async, [this, release, requests = std::move(requests), sink = std::move(sink), threadCount]() {
+                try {
+                    extractQueued(requests, sink, threadCount);
+                }
+                catch (...) {
+                    release();
+                    throw;
+                }
+                release();
+            });
+        }
+        catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    void ZipArchive::uncache(std::size_t slot)
+    {
+        const auto& info  = m_entries[slot];
+        auto        guard = lock();
+        if (info.isInArchive) {
+            m_cache.erase(info.fileIndex);
+            m_seekIndexes.erase(info.fileIndex);
+        }
+    }
+
+    void ZipArchive::waitForExtractions() const
+    {
+        if (!m_extractions) return;
+        std::unique_lock<std::mutex> guard(m_extractions->mutex);
+        m_extractions->finished.wait(guard, [&]() { return m_extractions->count == 0; });
+    }
+
+    void ZipArchive::extractQueued(const std::vector<std::pair<uint64_t, std::size_t>>& requests, const ZipEntrySink& sink, std::size_t threadCount) const
+    {
+        // ===== A job is an entry to decompress, with the buffer holding its local header and compressed data. Memory
+        // mapped archives are decompressed in place, and large, new or modified entries are read by the worker. The
+        // charge is the number of bytes counted against MaxAsyncBufferSize until the job is done.
+        struct Job
+        {
+            std::size_t                slot { 0 };
+            std::vector<unsigned char> buffer = {};
+            uint64_t                   charge { 0 };
+        };
+
+        const auto* mapped      = static_cast<const unsigned char*>(m_archive.m_pState->m_pMem);
+        auto        archiveSize = m_archive.m_archive_size;
+        auto        readSize    = [&](std::size_t slot) -> uint64_t {
+            const auto& info = record(slot);
+            if (mapped || updatedProxy(slot) || !info.isInArchive) return 0;
+            auto size = estimatedEnd(info, archiveSize) - info.localHeaderOffset;
+            return size <= MaxAsyncReadSize ? size : 0;
+        };
+
+        // ===== Entries too large to be read at once can't be passed to the sink in parts, so the worker decompresses
+        // them into a buffer of the uncompressed size, which counts against the budget like the read buffers.
+        auto chargeOf = [&](std::size_t slot, uint64_t size) -> uint64_t {
+            const auto& info = record(slot);
+            if (size > 0) return size;
+            return mapped || updatedProxy(slot) || !info.isInArchive ? 0 : info.uncompressedSize;
+        };
+
+        std::mutex              mutex;
+        std::condition_variable ready;
+        std::condition_variable released;
+        std::deque<Job>         jobs;
+        uint64_t                held { 0 };
+        bool                    isDone { false };
+        std::atomic<bool>       isFailed { false };
+        std::exception_ptr      error;
+        auto                    fail = [&]() {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (!error) error = std::current_exception();
+            isFailed = true;
+            released.notify_all();
+        };
+
+        // ===== The workers decompress the jobs and call the sink.
+        auto decode = [&](Job& job, WorkerReader& reader, std::vector<unsigned char>& data) {
+            const auto& info = record(job.slot);
+            const auto* item = updatedProxy(job.slot);
+            if (item) {
+                sink(entryName(job.slot), item->rawData());
+                return;
+            }
+
+            data.clear();
+            if (info.isInArchive) {
+                const auto* header    = mapped ? mapped + info.localHeaderOffset : job.buffer.data();
+                auto        available = mapped ? archiveSize - info.localHeaderOffset : job.buffer.size();
+                if ((!mapped && job.buffer.empty()) || !inflateEntry(job.slot, header, available, data)) {
+                    auto  stat     = fileStat(job.slot);
+                    auto& archive  = reader.archive();
+                    auto  isVerify = isVerifying(job.slot, ZipVerification::Default);
+                    auto  flags    = isVerify ? 0 : mz_uint { MZ_ZIP_FLAG_SKIP_CRC32_CHECK };
+                    data.resize(static_cast<std::size_t>(info.uncompressedSize));
+                    if (!mz_zip_reader_extract_to_mem_no_alloc1(&archive, info.fileIndex, data.data(), data.size(), flags, nullptr, 0, &stat)) {
+                        throw ZipRuntimeError(mz_zip_get_error_string(archive.m_last_error));
+                    }
+                    if (isVerify) setVerified(job.slot);
+                }
+            }
+            sink(entryName(job.slot), data);
+        };
+
+        auto workerCount = std::min<std::size_t>(threadCount > 0 ? threadCount : std::max(1U, std::thread::hardware_concurrency()), requests.size());
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back([&]() {
+                auto                       reader = WorkerReader(m_archivePath, m_mapping);
+                std::vector<unsigned char> data;
+                while (true) {
+                    Job job;
+                    {
+                        std::unique_lock<std::mutex> guard(mutex);
+                        ready.wait(guard, [&]() { return !jobs.empty() || isDone; });
+                        if (jobs.empty()) return;
+                        job = std::move(jobs.front());
+                        jobs.pop_front();
+                    }
+
+                    try {
+                        if (!isFailed) decode(job, reader, data);
+                    }
+                    catch (...) {
+                        fail();
+                    }
+
+                    std::lock_guard<std::mutex> guard(mutex);
+                    held -= job.charge;
+                    released.notify_one();
+                }
+            });
+        }
+
+        auto push = [&](Job job) {
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                jobs.push_back(std::move(job));
+            }
+            ready.notify_one();
+        };
+
+        // ===== Submit the reads in the order of the archive file, keeping up to AsyncQueueDepth reads in flight, and
+        // pass each entry to the workers when its read completes. The read buffers must outlive the queue.
+        try {
+            std::vector<Job>         reads(requests.size());
+            std::optional<ReadQueue> queue;
+            if (!mapped) queue.emplace(m_archivePath, AsyncQueueDepth);
+
+            std::size_t next = 0;
+            while ((next < requests.size() || (queue && queue->pending() > 0)) && !isFailed) {
+                for (; next < requests.size() && !isFailed; ++next) {
+                    auto slot   = requests[next].second;
+                    auto size   = readSize(slot);
+                    auto charge = chargeOf(slot, size);
+                    if (size > 0 && queue->pending() >= queue->depth()) break;
+                    if (charge > 0) {
+                        std::unique_lock<std::mutex> guard(mutex);
+                        if (held > 0 && held + charge > MaxAsyncBufferSize) {
+                            if (queue && queue->pending() > 0) break;
+                            released.wait(guard, [&]() { return held == 0 || held + charge <= MaxAsyncBufferSize || isFailed; });
+                        }
+                        held += charge;
+                    }
+
+                    if (size == 0) {
+                        push(Job { slot, {}, charge });
+                        continue;
+                    }
+                    reads[next] = Job { slot, std::vector<unsigned char>(static_cast<std::size_t>(size)), charge };
+                    queue->submit(next, requests[next].first, reads[next].buffer.data(), reads[next].buffer.size());
+                }
+
+                if (queue && queue->pending() > 0) {
+                    auto [tag, isRead] = queue->wait();
+                    if (!isRead) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_FILE_READ_FAILED));
+                    push(std::move(reads[tag]));
+                }
+            }
+        }
+        catch (...) {
+            fail();
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            isDone = true;
+        }
+        ready.notify_all();
+        for (auto& worker : workers) worker.join();
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    bool ZipArchive::inflateEntry(std::size_t slot, const unsigned char* header, uint64_t available, std::vector<unsigned char>& data) const
+    {
+        const auto& info = record(slot);
+        if (available < MZ_ZIP_LOCAL_DIR_HEADER_SIZE) return false;
+        if (MZ_READ_LE32(header) != MZ_ZIP_LOCAL_DIR_HEADER_SIG) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_INVALID_HEADER_OR_CORRUPTED));
+
+        auto start = MZ_ZIP_LOCAL_DIR_HEADER_SIZE + MZ_READ_LE16(header + MZ_ZIP_LDH_FILENAME_LEN_OFS) + MZ_READ_LE16(header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+        if (start + info.compressedSize > available) return false;
+
+        data.resize(static_cast<std::size_t>(info.uncompressedSize));
+        decodeEntry(slot, header + start, data.data(), isVerifying(slot, ZipVerification::Default));
+
+        return true;
+    }
+
+    bool ZipArchive::inflateInto(std::size_t slot, void* buffer, bool isVerify) const
+    {
+        const auto& info = record(slot);
+        if (m_inflateEngine == ZipInflateEngine::Miniz || info.method != MZ_DEFLATED || info.isEncrypted) return false;
+
+        // ===== Memory mapped archives are decompressed in place; otherwise, the compressed data is read in one go, as
+        // long as it is small enough to be held in memory.
+        auto&       archive = const_cast<mz_zip_archive&>(m_archive);    // NOLINT
+        const auto* source  = static_cast<const unsigned char*>(archive.m_pState->m_pMem);
+        if (!source && info.compressedSize > MaxBatchSize) return false;
+
+        // ===== Small entries are read through a fixed-size buffer kept per thread, and larger ones through a buffer for
+        // this call only, so that threads don't hold on to large buffers.
+        thread_local std::vector<unsigned char> readBuffer(MZ_ZIP_MAX_IO_BUF_SIZE);
+        std::vector<unsigned char>              largeBuffer;
+
+        auto offset = dataOffset(slot);
+        if (source)
+            source += offset;
+        else {
+            auto  size   = static_cast<std::size_t>(info.compressedSize);
+            auto* target = readBuffer.data();
+            if (size > readBuffer.size()) {
+                largeBuffer.resize(size);
+                target = largeBuffer.data();
+            }
+            if (archive.m_pRead(archive.m_pIO_opaque, offset, target, size) != size) {
+                throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_FILE_READ_FAILED));
+            }
+            source = target;
+        }
+
+        decodeEntry(slot, source, static_cast<unsigned char*>(buffer), isVerify);
+        return true;
+    }
+
+    void ZipArchive::decodeEntry(std::size_t slot, const unsigned char* source, unsigned char* destination, bool isVerify) const
+    {
+        const auto& info = record(slot);
+        if (info.isEncrypted || (info.method != 0 && info.method != MZ_DEFLATED)) {
+            throw ZipRuntimeError("KZip Error: Entry '" + std::string(entryName(slot)) + "' is encrypted or uses an unsupported compression method");
+        }
+
+        auto size = static_cast<std::size_t>(info.uncompressedSize);
+        if (info.method == 0) {
+            if (info.compressedSize != info.uncompressedSize) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_INVALID_HEADER_OR_CORRUPTED));
+            if (size > 0) std::memcpy(destination, source, size);
+        }
+        else if (inflateBuffer(m_inflateEngine, source, static_cast<std::size_t>(info.compressedSize), destination, size) != size) {
+            throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_DECOMPRESSION_FAILED));
+        }
+
+        if (isVerify) {
+            if (mz_crc32(MZ_CRC32_INIT, destination, size) != info.crc32) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_CRC_CHECK_FAILED));
+            setVerified(slot);
+        }
+    }
+
+    bool ZipArchive::isVerifying(std::size_t slot, ZipVerification verification) const
+    {
+        if (verification == ZipVerification::Default) verification = m_verification;
+        if (verification != ZipVerification::FirstRead) return verification == ZipVerification::Always;
+
+        auto guard = lock();
+        return !m_entries[slot].isVerified;
+    }
+
+    void ZipArchive::setVerified(std::size_t slot) const
+    {
+        // ===== The verification result doesn't change the observable state of the archive, so it is recorded also for
+        // const objects.
+        auto guard = lock();
+        const_cast<ZipEntryRecord&>(m_entries[slot]).isVerified = true;    // NOLINT
+    }
+
+    ZipEntryRecord ZipArchive::createRecord(std::string_view name)
+    {
+        auto record        = ZipEntryRecord();
+        record.fileIndex   = ++m_currentIndex;
+        record.time        = std::time(nullptr);
+        record.isDirectory = (name.back() == '/');
+
+        return record;
+    }
+
+    void ZipArchive::storeName(ZipEntryRecord& record, std::string_view name)
+    {
+        record.nameOffset = m_nameArena.size();
+        record.nameLength = static_cast<uint32_t>(name.size());
+        m_nameArena.append(name.data(), name.size());
+        m_nameArena.push_back('\0');
+    }
+
+    const ZipEntryRecord& ZipArchive::record(std::size_t slot) const
+    {
+        // ===== Reading the metadata doesn't change the observable state of the archive, so it is done on demand, also
+        // for const objects.
+        auto  guard  = lock();
+        auto& record = const_cast<ZipEntryRecord&>(m_entries[slot]);    // NOLINT
+        if (!record.isLoaded) {
+            auto cache = DosTimeCache();
+            decodeStats(record, const_cast<mz_zip_archive&>(m_archive), record.fileIndex, cache);    // NOLINT
+        }
+
+        return record;
+    }
+
+    ZipEntryProxy& ZipArchive::proxy(std::size_t slot) const
+    {
+        // ===== Creating the ZipEntryProxy object doesn't change the observable state of the archive, so it is done
+        // on demand, also for const objects.
+        auto  guard = lock();
+        auto& item  = m_proxies[slot];
+        if (!item) item.reset(new ZipEntryProxy(const_cast<ZipArchive*>(this), slot));    // NOLINT
+
+        return *item;
+    }
+
+    const ZipEntryProxy* ZipArchive::updatedProxy(std::size_t slot) const
+    {
+        auto        guard = lock();
+        const auto* item  = m_proxies[slot].get();
+        return item && item->isUpdated() ? item : nullptr;
+    }
+
+    mz_zip_archive_file_stat ZipArchive::fileStat(std::size_t slot) const
+    {
+        const auto& record = this->record(slot);
+        auto        name   = entryName(slot);
+
+        mz_zip_archive_file_stat info = mz_zip_archive_file_stat();
+        info.m_file_index             = record.fileIndex;
+        info.m_method                 = record.method;
+        info.m_time                   = record.time;
+        info.m_crc32                  = record.crc32;
+        info.m_comp_size              = record.compressedSize;
+        info.m_uncomp_size            = record.uncompressedSize;
+        info.m_local_header_ofs       = record.localHeaderOffset;
+        info.m_is_directory           = record.isDirectory;
+        info.m_is_encrypted           = record.isEncrypted;
+        info.m_bit_flag               = record.isEncrypted ? MZ_ZIP_GENERAL_PURPOSE_BIT_FLAG_IS_ENCRYPTED : 0;
+        info.m_is_supported           = record.isSupported;
+        name.copy(info.m_filename, std::min(name.size(), sizeof info.m_filename - 1));
+
+        return info;
+    }
+
+    uint64_t ZipArchive::dataOffset(std::size_t slot) const
+    {
+        const auto& info    = record(slot);
+        auto&       archive = const_cast<mz_zip_archive&>(m_archive);    // NOLINT
+
+        mz_uint8 header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
+        if (archive.m_pRead(archive.m_pIO_opaque, info.localHeaderOffset, header, sizeof header) != sizeof header) {
+            throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_FILE_READ_FAILED));
+        }
+        if (MZ_READ_LE32(header) != MZ_ZIP_LOCAL_DIR_HEADER_SIG) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_INVALID_HEADER_OR_CORRUPTED));
+
+        auto offset = info.localHeaderOffset + sizeof header + MZ_READ_LE16(header + MZ_ZIP_LDH_FILENAME_LEN_OFS) + MZ_READ_LE16(header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+        if (offset + info.compressedSize > archive.m_archive_size) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_INVALID_HEADER_OR_CORRUPTED));
+
+        return offset;
+    }
+
+    ZipCompressedData ZipArchive::compressedData(std::size_t slot) const
+    {
+        const auto&       info = record(slot);
+        ZipCompressedData result;
+        if (!info.isInArchive || info.isDirectory) return result;
+        if (info.isEncrypted) throw ZipRuntimeError("KZip Error: Entry '" + std::string(entryName(slot)) + "' is encrypted");
+
+        result.m_size             = info.compressedSize;
+        result.m_uncompressedSize = info.uncompressedSize;
+        result.m_crc32            = info.crc32;
+        result.m_method           = info.method;
+
+        // ===== Memory mapped archives are referred to directly; otherwise, the data is read into the buffer of the result.
+        auto  offset  = dataOffset(slot);
+        auto& archive = const_cast<mz_zip_archive&>(m_archive);    // NOLINT
+        if (const auto* memory = static_cast<const unsigned char*>(archive.m_pState->m_pMem)) {
+            result.m_data = memory + offset;
+        }
+        else {
+            result.m_buffer.resize(static_cast<std::size_t>(info.compressedSize));
+            if (archive.m_pRead(archive.m_pIO_opaque, offset, result.m_buffer.data(), result.m_buffer.size()) != result.m_buffer.size()) {
+                throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_FILE_READ_FAILED));
+            }
+        }
+
+        return result;
+    }
+
+    std::size_t ZipArchive::readRange(std::size_t slot, uint64_t offset, void* buffer, std::size_t size) const
+    {
+        const auto& info = record(slot);
+        if (!info.isInArchive || info.isDirectory || offset >= info.uncompressedSize) return 0;
+        if (info.isEncrypted || (info.method != 0 && info.method != MZ_DEFLATED)) {
+            throw ZipRuntimeError("KZip Error: Entry '" + std::string(entryName(slot)) + "' is encrypted or uses an unsupported compression method");
+        }
+
+        auto  count   = static_cast<std::size_t>(std::min<uint64_t>(size, info.uncompressedSize - offset));
+        auto& archive = const_cast<mz_zip_archive&>(m_archive);    // NOLINT
+        auto  readAt  = [&archive](uint64_t position, void* data, std::size_t length) {
+            if (archive.m_pRead(archive.m_pIO_opaque, position, data, length) != length) throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_FILE_READ_FAILED));
+        };
+
+        // ===== Get the seek index of the entry, creating it on first use. The position of the compressed data is found
+        // from the local header, which is only read once.
+        ZipSeekIndex* index = nullptr;
+        {
+            auto guard = lock();
+            auto item  = m_seekIndexes.find(info.fileIndex);
+            if (item != m_seekIndexes.end()) index = &item->second;
+        }
+
+        if (!index) {
+            auto dataStart = dataOffset(slot);
+            auto guard     = lock();
+            index          = &m_seekIndexes.try_emplace(info.fileIndex, dataStart, m_seekInterval).first->second;
+        }
+
+        // ===== Stored data is read directly.
+        if (info.method == 0) {
+            readAt(index->dataOffset() + offset, buffer, count);
+            return count;
+        }
+
+        // ===== Resume decompression from the last checkpoint before the range (or from the start of the entry), and copy
+        // the output within the range to the buffer. The output window is used as a circular buffer, in which the write
+        // position always equals the output position modulo the window size.
+        std::shared_ptr<const ZipSeekIndex::Checkpoint> start;
+        uint64_t                                        nextCheckpoint = 0;
+        {
+            auto guard     = lock();
+            start          = index->find(offset);
+            nextCheckpoint = index->nextOffset();
+        }
+
+        auto state = start ? *start : ZipSeekIndex::Checkpoint();
+        if (!start) {
+            tinfl_init(&state.decompressor);
+            state.window.resize(TINFL_LZ_DICT_SIZE);
+        }
+
+        thread_local std::vector<unsigned char> readBuffer(MZ_ZIP_MAX_IO_BUF_SIZE);
+        const auto*          memory    = static_cast<const mz_uint8*>(archive.m_pState->m_pMem);
+        const unsigned char* input     = nullptr;
+        std::size_t          available = 0;
+        auto*                output    = static_cast<unsigned char*>(buffer);
+        auto                 last      = offset + count;
+
+        while (state.outputOffset < last) {
+            // ===== Memory mapped archives are decompressed in place; otherwise, the compressed data is read in chunks.
+            if (available == 0 && state.inputOffset < info.compressedSize) {
+                auto remaining = info.compressedSize - state.inputOffset;
+                if (memory) {
+                    input     = memory + index->dataOffset() + state.inputOffset;
+                    available = static_cast<std::size_t>(remaining);
+                }
+                else {
+                    available = static_cast<std::size_t>(std::min<uint64_t>(remaining, readBuffer.size()));
+                    readAt(index->dataOffset() + state.inputOffset, readBuffer.data(), available);
+                    input = readBuffer.data();
+                }
+            }
+
+            auto windowOffset = static_cast<std::size_t>(state.outputOffset & (TINFL_LZ_DICT_SIZE - 1));
+            auto inputSize    = available;
+            auto outputSize   = TINFL_LZ_DICT_SIZE - windowOffset;
+            auto flags        = state.inputOffset + available < info.compressedSize ? TINFL_FLAG_HAS_MORE_INPUT : 0;
+            auto status       = tinfl_decompress(&state.decompressor,
+                                           input,
+                                           &inputSize,
+                                           state.window.data(),
+                                           state.window.data() + windowOffset,
+                                           &outputSize,
+                                           static_cast<mz_uint32>(flags));
+            input += inputSize;
+            available -= inputSize;
+            state.inputOffset += inputSize;
+
+            auto first = std::max(state.outputOffset, offset);
+            auto end   = std::min(state.outputOffset + outputSize, last);
+            if (first < end) std::memcpy(output + (first - offset), state.window.data() + windowOffset + (first - state.outputOffset), end - first);
+            state.outputOffset += outputSize;
+
+            if (status < TINFL_STATUS_DONE || (status == TINFL_STATUS_DONE && state.outputOffset < last))
+                throw ZipRuntimeError(mz_zip_get_error_string(MZ_ZIP_DECOMPRESSION_FAILED));
+
+            // ===== Record a checkpoint once the output is an interval beyond the last one in the index.
+            if (status != TINFL_STATUS_DONE && state.outputOffset >= nextCheckpoint) {
+                auto checkpoint = std::make_shared<const ZipSeekIndex::Checkpoint>(state);
+                auto guard      = lock();
+                index->add(std::move(checkpoint));
+                nextCheckpoint = index->nextOffset();
+            }
+        }
+
+        return count;
+    }
+
+    std::string_view ZipArchive::centralDirName(uint32_t fileIndex) const
+    {
+        const auto* header = mz_zip_get_cdh(const_cast<mz_zip_archive*>(&m_archive), fileIndex);    // NOLINT
+        if (!header) throw ZipRuntimeError("KZip Error: Invalid central directory index");
+
+        return { reinterpret_cast<const char*>(header) + MZ_ZIP_CENTRAL_DIR_HEADER_SIZE, MZ_READ_LE16(header + MZ_ZIP_CDH_FILENAME_LEN_OFS) };    // NOLINT
+    }
+
+    std::string_view ZipArchive::entryName(std::size_t slot) const
+    {
+        const auto& record = m_entries[slot];
+        return { m_nameArena.data() + record.nameOffset, record.nameLength };
+    }
+
+    std::size_t ZipArchive::findEntry(std::string_view name) const
+    {
+        return m_entryIndex.find(name, [this](std::size_t slot) { return entryName(slot); });
+    }
+
+    std::size_t ZipArchive::appendEntry(ZipEntryRecord record, std::string_view name)
+    {
+        // ===== If the table would have to grow anyway, and at least half of it is deleted entries, compact it instead.
+        if (m_deletedCount > 0 && m_entries.size() == m_entries.capacity() && m_deletedCount * 2 >= m_entries.size())
+            compact();
+
+        storeName(record, name);
+        m_entries.push_back(record);
+        m_proxies.emplace_back();
+        auto slot = m_entries.size() - 1;
+        m_entryIndex.insert(entryName(slot), slot);
+        m_pendingSlots.push_back(slot);
+
+        return slot;
+    }
+
+    void ZipArchive::registerParentFolders(std::string_view name)
+    {
+        auto parentEnd = name.substr(0, name.size() - 1).rfind('/');
+        if (parentEnd == std::string_view::npos) return;
+
+        // ===== Walk up the path until a registered folder is found.
+        auto position = parentEnd;
+        while (position != std::string_view::npos && findEntry(name.substr(0, position + 1)) == ZipEntryIndex::npos)
+            position = (position == 0 ? std::string_view::npos : name.rfind('/', position - 1));
+        if (position == parentEnd) return;
+
+        // ===== Register the missing folders from the top down. The name may refer to the name arena, which may be
+        // reallocated when appending entries, so a copy of the path is used.
+        auto path = std::string(name.substr(0, parentEnd + 1));
+        for (position = (position == std::string_view::npos ? path.find('/') : path.find('/', position + 1));
+             position != std::string::npos;
+             position = path.find('/', position + 1))
+        {
+            auto folderName = std::string_view(path).substr(0, position + 1);
+            appendEntry(createRecord(folderName), folderName);
+        }
+    }
+
+    void ZipArchive::renameEntry(std::size_t slot, const std::string& newName)
+    {
+        // ===== If an entry with the new name exists, delete it. As deleted entries are not removed from the table, this
+        // will not invalidate the entry being renamed.
+        if (findEntry(newName) != ZipEntryIndex::npos) deleteEntry(newName);
+
+        // ===== Unregister the old name, and register the new name. The old name is left unused in the name arena.
+        m_entryIndex.erase(entryName(slot), [this](std::size_t i) { return entryName(i); });
+        storeName(m_entries[slot], newName);
+        m_entryIndex.insert(entryName(slot), slot);
+
+        // ===== The position of the entry in the sorted index is no longer valid, so move it to the pending list.
+        m_sortedSlots.erase(std::remove(m_sortedSlots.begin(), m_sortedSlots.end(), slot), m_sortedSlots.end());
+        m_pendingSlots.push_back(slot);
+
+        // ===== Finally, ensure that the folders in the new name are registered. This may compact the entry table.
+        registerParentFolders(newName);
+    }
+
+    void ZipArchive::compact()
+    {
+        // ===== Move the live entries (and their ZipEntryProxy objects) to the front of the table, and rebuild the name
+        // arena, to release the names of deleted and renamed entries.
+        std::string nameArena;
+        std::size_t count = 0;
+        for (std::size_t slot = 0; slot < m_entries.size(); ++slot) {
+            if (m_entries[slot].isDeleted) continue;
+
+            auto name          = entryName(slot);
+            m_entries[count]   = m_entries[slot];
+            m_proxies[count]   = std::move(m_proxies[slot]);
+            if (m_proxies[count]) m_proxies[count]->m_slot = count;
+
+            m_entries[count].nameOffset = nameArena.size();
+            nameArena.append(name.data(), name.size());
+            nameArena.push_back('\0');
+            ++count;
+        }
+
+        m_entries.resize(count);
+        m_proxies.resize(count);
+        m_nameArena    = std::move(nameArena);
+        m_deletedCount = 0;
+
+        m_entryIndex.clear();
+        m_entryIndex.reserve(m_entries.size());
+        for (std::size_t slot = 0; slot < m_entries.size(); ++slot) m_entryIndex.insert(entryName(slot), slot);
+
+        rebuildSortedIndex();
+    }
+
+    bool ZipArchive::matchesFlags(std::size_t slot, ZipFlags flags) const
+    {
+        const auto& record = m_entries[slot];
+        if (record.isDeleted) return false;
+
+        return record.isDirectory ? static_cast<bool>(flags & ZipFlags::Directories) : static_cast<bool>(flags & ZipFlags::Files);
+    }
+
+    void ZipArchive::rebuildSortedIndex() const
+    {
+        m_sortedSlots.clear();
+        m_pendingSlots.clear();
+        m_sortedSlots.reserve(m_entries.size());
+        for (std::size_t slot = 0; slot < m_entries.size(); ++slot)
+            if (!m_entries[slot].isDeleted) m_sortedSlots.push_back(slot);
+
+        // ===== For large archives, the slots are sorted in chunks on separate threads, and the chunks are then merged
+        // pairwise, also in parallel.
+        auto isLess = [this](std::size_t a, std::size_t b) { return entryName(a) < entryName(b); };
+        auto count  = m_sortedSlots.size();
+        auto chunks = chunkCount(count, m_threadCount, MinEntriesPerThread);
+        auto begin  = m_sortedSlots.begin();
+        parallelFor(count, m_threadCount, MinEntriesPerThread, [&](std::size_t first, std::size_t last, std::size_t) {
+            std::sort(begin + first, begin + last, isLess);
+        });
+
+        for (std::size_t width = 1; width < chunks; width *= 2) {
+            auto merges = (chunks + 2 * width - 1) / (2 * width);
+            parallelFor(merges, m_threadCount, 1, [&](std::size_t first, std::size_t last, std::size_t) {
+                for (auto merge = first; merge < last; ++merge) {
+                    auto lower  = merge * 2 * width;
+                    auto middle = std::min(lower + width, chunks);
+                    auto upper  = std::min(lower + 2 * width, chunks);
+                    if (middle == upper) continue;
+                    std::inplace_merge(begin + count * lower / chunks, begin + count * middle / chunks, begin + count * upper / chunks, isLess);
+                }
+            });
+        }
+    }
+
+    std::size_t ZipArchive::skipPrefix(const std::size_t* slots, std::size_t first, std::size_t last, std::string_view prefix) const
+    {
+        auto hasPrefix = [&](std::size_t slot) { return entryName(slot).substr(0, prefix.size()) == prefix; };
+        return static_cast<std::size_t>(std::partition_point(slots + first, slots + last, hasPrefix) - slots);
+    }
+
+    fs::path ZipArchive::indexFilePath() const { return fs::path(m_archivePath).concat(".kzidx"); }
+
+    bool ZipArchive::readIndexFile()
+    {
+        std::error_code error;
+        auto            archiveSize = fs::file_size(m_archivePath, error);
+        auto            archiveTime = fs::last_write_time(m_archivePath, error).time_since_epoch().count();
+        if (error) return false;
+
+        std::ifstream stream(indexFilePath(), std::ios::binary);
+        if (!stream) return false;
+
+        // ===== Check that the index file is valid, and up to date with the archive file.
+        auto header   = IndexFileHeader();
+        auto expected = IndexFileHeader();
+        if (!stream.read(reinterpret_cast<char*>(&header), sizeof header)) return false;    // NOLINT
+        if (std::memcmp(header.magic, expected.magic, sizeof header.magic) != 0 || header.version != expected.version ||
+            header.recordSize != expected.recordSize || header.wordSize != expected.wordSize || header.archiveSize != archiveSize ||
+            header.archiveTime != static_cast<int64_t>(archiveTime) || header.fileCount != mz_zip_reader_get_num_files(&m_archive))
+            return false;
+
+        // ===== The sizes of the tables are checked against the size of the index file before anything is allocated.
+        auto indexSize = fs::file_size(indexFilePath(), error);
+        if (error || indexSize < sizeof header) return false;
+        auto available = indexSize - sizeof header;
+        auto reserve   = [&](uint64_t count, uint64_t elementSize) {
+            if (count > available / elementSize) return false;
+            available -= count * elementSize;
+            return true;
+        };
+        if (!reserve(header.entryCount, sizeof(ZipEntryRecord)) || !reserve(header.nameArenaSize, 1) ||
+            !reserve(header.sortedCount, sizeof(std::size_t)) || header.entryCount < header.fileCount ||
+            header.sortedCount > header.entryCount || header.deletedCount > header.entryCount)
+            return false;
+
+        // ===== Read the tables, and check that all slots and names are in bounds. The first records are the entries of
+        // the archive file, in order; the records after those can only be folders added when the archive was opened. If
+        // any of the tables are incomplete or inconsistent, the tables are discarded, and rebuilt by the caller.
+        m_nameArena.resize(header.nameArenaSize);
+        auto isValid = readVector(stream, m_entries, header.entryCount) &&
+                       stream.read(m_nameArena.data(), static_cast<std::streamsize>(header.nameArenaSize)) &&
+                       readVector(stream, m_sortedSlots, header.sortedCount) && m_entryIndex.read(stream, m_entries.size(), available);
+        for (std::size_t slot = 0; isValid && slot < m_entries.size(); ++slot) {
+            const auto& record = m_entries[slot];
+            isValid = record.nameOffset <= m_nameArena.size() && record.nameLength <= m_nameArena.size() - record.nameOffset &&
+                      (slot < header.fileCount ? record.isInArchive && record.fileIndex == slot : !record.isInArchive && record.isDirectory);
+        }
+        for (std::size_t i = 0; isValid && i < m_sortedSlots.size(); ++i) isValid = m_sortedSlots[i] < m_entries.size();
+
+        if (!isValid) {
+            m_entries.clear();
+            m_nameArena.clear();
+            m_sortedSlots.clear();
+            m_entryIndex.clear();
+            return false;
+        }
+
+        // ===== Checksum verifications only hold for as long as the archive is open, so they are not restored.
+        for (auto& record : m_entries) record.isVerified = false;
+
+        m_proxies.resize(m_entries.size());
+        m_deletedCount  = header.deletedCount;
+        m_shadowedCount = header.deletedCount;
+        m_currentIndex  = static_cast<uint32_t>(header.currentIndex);
+        return true;
+    }
+
+    void ZipArchive::writeIndexFile() const
+    {
+        std::error_code error;
+        auto            header = IndexFileHeader();
+        header.archiveSize     = fs::file_size(m_archivePath, error);
+        header.archiveTime     = fs::last_write_time(m_archivePath, error).time_since_epoch().count();
+        if (error) return;
+
+        // ===== Merge any pending entries into the sorted index, so that it can be stored in full.
+        prefixRange("");
+        header.fileCount     = mz_zip_reader_get_num_files(const_cast<mz_zip_archive*>(&m_archive));    // NOLINT
+        header.entryCount    = m_entries.size();
+        header.nameArenaSize = m_nameArena.size();
+        header.sortedCount   = m_sortedSlots.size();
+        header.deletedCount  = m_deletedCount;
+        header.currentIndex  = m_currentIndex;
+
+        // ===== Write to a temporary file first, so that a partially written index file is never used.
+        auto tempPath = fs::path(indexFilePath()).concat(".tmp");
+        {
+            std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+            stream.write(reinterpret_cast<const char*>(&header), sizeof header);    // NOLINT
+            writeVector(stream, m_entries);
+            stream.write(m_nameArena.data(), static_cast<std::streamsize>(m_nameArena.size()));
+            writeVector(stream, m_sortedSlots);
+            m_entryIndex.write(stream);
+            if (!stream) {
+                stream.close();
+                fs::remove(tempPath, error);
+                return;
+            }
+        }
+
+        fs::rename(tempPath, indexFilePath(), error);
+        if (error) fs::remove(tempPath, error);
+    }
+
+    std::unique_lock<std::mutex> ZipArchive::lock() const { return m_mutex ? std::unique_lock(*m_mutex) : std::unique_lock<std::mutex>(); }
+
+    std::pair<std::vector<std::size_t>::const_iterator, std::vector<std::size_t>::const_iterator>
+        ZipArchive::prefixRange(std::string_view prefix) const
+    {
+        // ===== Merge the entries added since the last query into the sorted index, dropping deleted entries on the way.
+        auto guard = lock();
+        if (!m_pendingSlots.empty() || m_sortedSlots.size() + m_deletedCount > m_entries.size()) {
+            auto byName    = [this](std::size_t a, std::size_t b) { return entryName(a) < entryName(b); };
+            auto isDeleted = [this](std::size_t slot) { return m_entries[slot].isDeleted; };
+
+            m_sortedSlots.erase(std::remove_if(m_sortedSlots.begin(), m_sortedSlots.end(), isDeleted), m_sortedSlots.end());
+            m_pendingSlots.erase(std::remove_if(m_pendingSlots.begin(), m_pendingSlots.end(), isDeleted), m_pendingSlots.end());
+            std::sort(m_pendingSlots.begin(), m_pendingSlots.end(), byName);
+
+            auto middle = m_sortedSlots.insert(m_sortedSlots.end(), m_pendingSlots.begin(), m_pendingSlots.end());
+            std::inplace_merge(m_sortedSlots.begin(), middle, m_sortedSlots.end(), byName);
+            m_pendingSlots.clear();
+        }
+
+        // ===== All names with the given prefix form a contiguous range in the sorted index.
+        auto first = std::lower_bound(m_sortedSlots.cbegin(), m_sortedSlots.cend(), prefix, [this](std::size_t slot, std::string_view value) {
+            return entryName(slot) < value;
+        });
+        auto last  = std::upper_bound(first, m_sortedSlots.cend(), prefix, [this](std::string_view value, std::size_t slot) {
+            return value < entryName(slot).substr(0, value.size());
+        });
+
+        return { first, last };
+    }
+
+} // namespace KZip::Impl
+
+namespace KZip::Impl {
+
+    namespace {
+        using Crc32Tables   = std::array<std::array<uint32_t, 256>, 16>;
+        using Crc32Function = uint32_t (*)(uint32_t, const unsigned char*, std::size_t);
+
+        /**
+         * @brief Create the lookup tables for the table driven CRC-32 implementations.
+         * @details The first table is the usual byte-wise table for the (reflected) polynomial 0xEDB88320. Table k holds
+         * the CRC of a byte followed by k zero bytes, so that 16 bytes can be processed with 16 independent lookups.
+         */
+        constexpr Crc32Tables createCrc32Tables()
+        {
+            Crc32Tables tables = {};
+            for (uint32_t i = 0; i < 256; ++i) {
+                auto crc = i;
+                for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+                tables[0][i] = crc;
+            }
+            for (std::size_t k = 1; k < tables.size(); ++k)
+                for (std::size_t i = 0; i < 256; ++i) tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+
+            return tables;
+        }
+
+        constexpr Crc32Tables Crc32Table = createCrc32Tables();
+
+        /**
+         * @brief Read a little endian 32-bit value from unaligned memory.
+         */
+        uint32_t readLE32(const unsigned char* data)
+        {
+#if MINIZ_LITTLE_ENDIAN
+            uint32_t value = 0;
+            std::memcpy(&value, data, sizeof value);
+            return value;
+#else
+            return MZ_READ_LE32(data);
+#endif
+        }
+
+        // ===== The implementations below work on the inverted checksum (the CRC register), i.e. the caller inverts the
+        // checksum before and after.
+
+        uint32_t crc32Bytewise(uint32_t crc, const unsigned char* data, std::size_t size)
+        {
+            for (; size > 0; --size) crc = (crc >> 8) ^ Crc32Table[0][(crc ^ *data++) & 0xFF];
+            return crc;
+        }
+
+        uint32_t crc32SliceBy16(uint32_t crc, const unsigned char* data, std::size_t size)
+        {
+            const auto& t = Crc32Table;
+            for (; size >= 16; size -= 16, data += 16) {
+                auto a = readLE32(data) ^ crc;
+                auto b = readLE32(data + 4);
+                auto c = readLE32(data + 8);
+                auto d = readLE32(data + 12);
+                crc    = t[15][a & 0xFF] ^ t[14][(a >> 8) & 0xFF] ^ t[13][(a >> 16) & 0xFF] ^ t[12][a >> 24] ^ t[11][b & 0xFF] ^
+                      t[10][(b >> 8) & 0xFF] ^ t[9][(b >> 16) & 0xFF] ^ t[8][b >> 24] ^ t[7][c & 0xFF] ^ t[6][(c >> 8) & 0xFF] ^
+                      t[5][(c >> 16) & 0xFF] ^ t[4][c >> 24] ^ t[3][d & 0xFF] ^ t[2][(d >> 8) & 0xFF] ^ t[1][(d >> 16) & 0xFF] ^
+                      t[0][d >> 24];
+            }
+
+            return crc32Bytewise(crc, data, size);
+        }
+
+#ifdef KZIP_CRC32_CLMUL
+        /**
+         * @brief Load 16 bytes from unaligned memory.
+         */
+        KZIP_TARGET_CLMUL inline __m128i loadClmul(const unsigned char* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }    // NOLINT
+
+        /**
+         * @brief Fold a 128-bit lane forward using the given constants, and add the next 16 bytes of data.
+         */
+        KZIP_TARGET_CLMUL inline __m128i foldClmul(__m128i lane, __m128i constants, __m128i next)
+        {
+            return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(lane, constants, 0x11), _mm_clmulepi64_si128(lane, constants, 0x00)), next);
+        }
+
+        /**
+         * @brief Compute the CRC-32 using carry-less multiplication, as described in "Fast CRC Computation for Generic
+         * Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).
+         * @details Four 128-bit lanes are folded in parallel over blocks of 64 bytes, then folded into a single lane,
+         * which is reduced to 32 bits with a Barrett reduction. The constants are those for the reflected polynomial.
+         * Data of less than 64 bytes, and the last bytes that don't fill a 16 byte block, are handled by slice-by-16.
+         */
+        KZIP_TARGET_CLMUL uint32_t crc32Clmul(uint32_t crc, const unsigned char* data, std::size_t size)
+        {
+            if (size < 64) return crc32SliceBy16(crc, data, size);
+
+            const auto k1k2 = _mm_set_epi64x(0x01C6E41596, 0x0154442BD4);
+            const auto k3k4 = _mm_set_epi64x(0x00CCAA009E, 0x01751997D0);
+            const auto k5k0 = _mm_set_epi64x(0x0000000000, 0x0163CD6124);
+            const auto poly = _mm_set_epi64x(0x01F7011641, 0x01DB710641);
+
+            auto x1 = _mm_xor_si128(loadClmul(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+            auto x2 = loadClmul(data + 16);
+            auto x3 = loadClmul(data + 32);
+            auto x4 = loadClmul(data + 48);
+            for (data += 64, size -= 64; size >= 64; data += 64, size -= 64) {
+                x1 = foldClmul(x1, k1k2, loadClmul(data));
+                x2 = foldClmul(x2, k1k2, loadClmul(data + 16));
+                x3 = foldClmul(x3, k1k2, loadClmul(data + 32));
+                x4 = foldClmul(x4, k1k2, loadClmul(data + 48));
+            }
+
+            // ===== Fold the four lanes into one, followed by any remaining 16 byte blocks.
+            x1 = foldClmul(x1, k3k4, x2);
+            x1 = foldClmul(x1, k3k4, x3);
+            x1 = foldClmul(x1, k3k4, x4);
+            for (; size >= 16; data += 16, size -= 16) x1 = foldClmul(x1, k3k4, loadClmul(data));
+
+            // ===== Fold 128 bits into 64 bits, and reduce to 32 bits.
+            auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+            x1        = _mm_xor_si128(_mm_srli_si128(x1, 8), _mm_clmulepi64_si128(x1, k3k4, 0x10));
+            x1        = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), k5k0, 0x00), _mm_srli_si128(x1, 4));
+
+            x2  = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), poly, 0x10);
+            x2  = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), poly, 0x00);
+            crc = static_cast<uint32_t>(_mm_extract_epi32(_mm_xor_si128(x1, x2), 1));
+
+            return crc32SliceBy16(crc, data, size);
+        }
+#endif
+
+#ifdef KZIP_CRC32_ARM
+        /**
+         * @brief Compute the CRC-32 using the CRC32 instructions of ARMv8, eight bytes at a time.
+         */
+        KZIP_TARGET_ARM_CRC uint32_t crc32ArmCrc(uint32_t crc, const unsigned char* data, std::size_t size)
+        {
+            for (; size > 0 && reinterpret_cast<uintptr_t>(data) % 8 != 0; --size) crc = __crc32b(crc, *data++);    // NOLINT
+            for (; size >= 8; size -= 8, data += 8) {
+                uint64_t value = 0;
+                std::memcpy(&value, data, sizeof value);
+                crc = __crc32d(crc, value);
+            }
+            for (; size > 0; --size) crc = __crc32b(crc, *data++);
+
+            return crc;
+        }
+#endif
+
+        /**
+         * @brief Get the function implementing a CRC-32 engine.
+         */
+        Crc32Function crc32Function(Crc32Engine engine)
+        {
+            switch (engine) {
+#ifdef KZIP_CRC32_CLMUL
+                case Crc32Engine::Clmul:
+                    return crc32Clmul;
+#endif
+#ifdef KZIP_CRC32_ARM
+                case Crc32Engine::ArmCrc:
+                    return crc32ArmCrc;
+#endif
+                case Crc32Engine::SliceBy16:
+                    return crc32SliceBy16;
+                default:
+                    return crc32Bytewise;
+            }
+        }
+    }    // namespace
+
+    bool isSupported(Crc32Engine engine)
+    {
+        switch (engine) {
+            case Crc32Engine::Bytewise:
+            case Crc32Engine::SliceBy16:
+                return true;
+
+            case Crc32Engine::Clmul:
+#if defined(KZIP_CRC32_CLMUL) && defined(_MSC_VER) && !defined(__clang__)
+            {
+                int info[4] = {};
+                __cpuid(info, 1);
+                return (info[2] & (1 << 1)) && (info[2] & (1 << 19));    // PCLMULQDQ and SSE4.1
+            }
+#elif defined(KZIP_CRC32_CLMUL)
+                return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#else
+                return false;
+#endif
+
+            case Crc32Engine::ArmCrc:
+#if defined(KZIP_CRC32_ARM) && defined(__linux__)
+                return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#elif defined(KZIP_CRC32_ARM) && defined(_WIN32)
+                return IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE);
+#elif defined(KZIP_CRC32_ARM) && (defined(__APPLE__) || defined(__ARM_FEATURE_CRC32))
+                return true;
+#else
+                return false;
+#endif
+        }
+
+        return false;
+    }
+
+    Crc32Engine crc32Engine()
+    {
+        static const auto engine = []() {
+            for (auto candidate : { Crc32Engine::Clmul, Crc32Engine::ArmCrc })
+                if (isSupported(candidate)) return candidate;
+            return Crc32Engine::SliceBy16;
+        }();
+
+        return engine;
+    }
+
+    uint32_t updateCrc32(Crc32Engine engine, uint32_t crc, const unsigned char* data, std::size_t size)
+    {
+        return ~crc32Function(engine)(~crc, data, size);
+    }
+
+} // namespace KZip::Impl
+
+/**
+ * @brief The CRC-32 function used by miniz (see USE_EXTERNAL_MZCRC in miniz.h), for all reads and writes of entry data.
+ * @details The implementation is selected once, on first use.
+ */
+extern "C" mz_ulong mz_crc32(mz_ulong crc, const unsigned char* ptr, size_t buf_len)
+{
+    static const auto function = KZip::Impl::crc32Function(KZip::Impl::crc32Engine());
+    if (!ptr) return MZ_CRC32_INIT;
+
+    return ~function(~static_cast<uint32_t>(crc), ptr, buf_len);
+}
+
+namespace KZip::Impl {
+
+    namespace {
+        // ===== The decoding tables of the fast inflate engine hold 32-bit entries: bits 0-5 hold the number of bits
+        // consumed by the entry, including any extra bits, bits 8-11 the kind of entry, bits 12-15 the number of extra bits of a length or distance
+        // (or the number of index bits of a subtable), and bits 16-31 the payload: one or two literals, the base of a
+        // length or distance, or the position of a subtable. Codes longer than the index bits of a table are decoded in
+        // two steps, through a subtable.
+
+        enum InflateKind : uint32_t { Literal, DoubleLiteral, Length, EndOfBlock, Distance, Subtable, Invalid };
+
+        constexpr unsigned MaxCodeBits         = 15;
+        constexpr unsigned LitlenTableBits     = 11;
+        constexpr unsigned DistTableBits       = 8;
+        constexpr unsigned CodeLengthTableBits = 7;
+
+        // ===== Each code longer than the index bits adds at most one subtable, with at most 2^(15 - bits) entries.
+        constexpr std::size_t LitlenTableSize     = (1U << LitlenTableBits) + 288 * (1U << (15 - LitlenTableBits));
+        constexpr std::size_t DistTableSize       = (1U << DistTableBits) + 32 * (1U << (15 - DistTableBits));
+        constexpr std::size_t CodeLengthTableSize = 1U << CodeLengthTableBits;
+
+        constexpr uint32_t inflateEntry(uint32_t kind, uint32_t payload = 0, uint32_t extraBits = 0)
+        {
+            return kind << 8 | extraBits << 12 | payload << 16;
+        }
+
+        constexpr uint32_t entryBits(uint32_t entry) { return entry & 0x3F; }
+        constexpr uint32_t entryKind(uint32_t entry) { return (entry >> 8) & 0xF; }
+        constexpr uint32_t entryExtraBits(uint32_t entry) { return (entry >> 12) & 0xF; }
+        constexpr uint32_t entryPayload(uint32_t entry) { return entry >> 16; }
+
+        /**
+         * @brief The decoded symbols of the literal/length, distance and code length alphabets, without the code lengths.
+         * @details Symbols 286 and 287 can't occur in valid streams; they are decoded as in tinfl, as matches of length 0.
+         */
+        struct InflateSymbols
+        {
+            std::array<uint32_t, 288> litlen {};
+            std::array<uint32_t, 32>  dist {};
+            std::array<uint32_t, 19>  codeLength {};
+
+            constexpr InflateSymbols()
+            {
+                constexpr uint16_t lengthBase[31]  = { 3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27, 31,
+                                                       35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258, 0,  0 };
+                constexpr uint8_t  lengthExtra[31] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0, 0, 0 };
+                constexpr uint16_t distBase[30]    = { 1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                                       193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+                constexpr uint8_t  distExtra[30]   = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+                for (uint32_t i = 0; i < 256; ++i) litlen[i] = inflateEntry(Literal, i);
+                litlen[256] = inflateEntry(EndOfBlock);
+                for (uint32_t i = 257; i < 288; ++i) litlen[i] = inflateEntry(Length, lengthBase[i - 257], lengthExtra[i - 257]);
+                for (uint32_t i = 0; i < 32; ++i) dist[i] = i < 30 ? inflateEntry(Distance, distBase[i], distExtra[i]) : inflateEntry(Invalid);
+                for (uint32_t i = 0; i < 19; ++i) codeLength[i] = inflateEntry(Literal, i);
+            }
+        };
+
+        constexpr InflateSymbols InflateSymbol = InflateSymbols();
+
+        /**
+         * @brief Build a decoding table from the code lengths of an alphabet.
+         * @details The codes are validated as in tinfl: the code must be complete, unless at most one symbol is used.
+         * Codes that aren't assigned decode as invalid. For the literal/length alphabet, entries for a literal whose code
+         * leaves room for the code of another literal within the index bits decode both literals at once.
+         * @param lengths The code lengths of the symbols.
+         * @param count The number of symbols.
+         * @param symbols The decoded symbols (see InflateSymbols).
+         * @param table The table to fill.
+         * @param tableBits The number of index bits of the table.
+         * @param isLitlen true if the table is for the literal/length alphabet.
+         * @return true if the code lengths are valid; otherwise false.
+         */
+        bool buildInflateTable(const uint8_t* lengths, std::size_t count, const uint32_t* symbols, uint32_t* table, unsigned tableBits, bool isLitlen)
+        {
+            uint32_t lengthCount[16] = {};
+            for (std::size_t i = 0; i < count; ++i) ++lengthCount[lengths[i]];
+
+            uint32_t nextCode[17] = {};
+            uint32_t total        = 0;
+            uint32_t used         = 0;
+            auto     isLong       = false;
+            for (unsigned length = 1; length <= 15; ++length) {
+                used += lengthCount[length];
+                nextCode[length + 1] = total = (total + lengthCount[length]) << 1;
+                if (length > tableBits && lengthCount[length] > 0) isLong = true;
+            }
+            if (total != 65536 && used > 1) return false;
+
+            auto tableSize = 1U << tableBits;
+            std::fill(table, table + tableSize, inflateEntry(Invalid));
+
+            // ===== For codes longer than the index bits, find the longest code per prefix, which sets the subtable size.
+            uint8_t maxLength[1U << LitlenTableBits];
+            if (isLong) {
+                std::fill(maxLength, maxLength + tableSize, uint8_t { 0 });
+                uint32_t code[17];
+                std::copy(nextCode, nextCode + 17, code);
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto length = lengths[i];
+                    if (length == 0) continue;
+                    auto reversed = 0U;
+                    for (uint32_t value = code[length]++, bit = 0; bit < length; ++bit, value >>= 1) reversed = (reversed << 1) | (value & 1);
+                    if (length > tableBits) maxLength[reversed & (tableSize - 1)] = std::max(maxLength[reversed & (tableSize - 1)], length);
+                }
+            }
+
+            // ===== Assign the codes in canonical order. The input is read from the least significant bit, so the table is
+            // indexed by the bit reversed codes.
+            auto subtableEnd = tableSize;
+            for (std::size_t i = 0; i < count; ++i) {
+                uint32_t length = lengths[i];
+                if (length == 0) continue;
+                auto reversed = 0U;
+                for (uint32_t value = nextCode[length]++, bit = 0; bit < length; ++bit, value >>= 1) reversed = (reversed << 1) | (value & 1);
+
+                if (length <= tableBits) {
+                    for (auto index = reversed; index < tableSize; index += 1U << length) table[index] = symbols[i] | (length + entryExtraBits(symbols[i]));
+                    continue;
+                }
+
+                auto  prefix = reversed & (tableSize - 1);
+                auto& entry  = table[prefix];
+                if (entryKind(entry) != Subtable) {
+                    auto subtableBits = maxLength[prefix] - tableBits;
+                    entry             = inflateEntry(Subtable, subtableEnd, subtableBits) | tableBits;
+                    std::fill(table + subtableEnd, table + subtableEnd + (1U << subtableBits), inflateEntry(Invalid));
+                    subtableEnd += 1U << subtableBits;
+                }
+
+                auto  subtableSize = 1U << entryExtraBits(entry);
+                auto* subtable     = table + entryPayload(entry);
+                for (auto index = reversed >> tableBits; index < subtableSize; index += 1U << (length - tableBits))
+                    subtable[index] = symbols[i] | (length - tableBits + entryExtraBits(symbols[i]));
+            }
+
+            // ===== Combine pairs of literals. The table is processed from the end, as the entry for the second literal is
+            // at a lower index, which must not have been combined yet.
+            if (isLitlen) {
+                for (auto index = tableSize; index-- > 0;) {
+                    auto first = table[index];
+                    if (entryKind(first) != Literal || entryBits(first) >= tableBits) continue;
+                    auto second = table[index >> entryBits(first)];
+                    if (entryKind(second) != Literal || entryBits(first) + entryBits(second) > tableBits) continue;
+                    table[index] = inflateEntry(DoubleLiteral, entryPayload(first) | entryPayload(second) << 8) | (entryBits(first) + entryBits(second));
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief The decoding tables of the fast inflate engine.
+         */
+        struct InflateTables
+        {
+            std::array<uint32_t, LitlenTableSize>     litlen;
+            std::array<uint32_t, DistTableSize>       dist;
+            std::array<uint32_t, CodeLengthTableSize> codeLength;
+        };
+
+        /**
+         * @brief The InflateBitReader struct reads the input of the fast inflate engine through a 64-bit bit buffer.
+         * @details The buffer is refilled once per symbol with a single 8-byte load, after which it holds at least 56 bits,
+         * enough for a complete length/distance pair. Past the end of the input, the buffer is padded with zeros; the
+         * stream is invalid if any of the padding is consumed.
+         */
+        struct InflateBitReader
+        {
+            const unsigned char* in;              /**< The next byte of input to load into the bit buffer. */
+            const unsigned char* inEnd;           /**< The end of the input. */
+            uint64_t             bits { 0 };      /**< The bit buffer; the next bit of input is the least significant bit. */
+            unsigned             count { 0 };     /**< The number of valid bits in the bit buffer. */
+            std::size_t          overrun { 0 };   /**< The number of zero bytes added to the bit buffer past the end of the input. */
+            uint64_t             saved { 0 };     /**< The bit buffer before the last decoded entry was consumed. */
+
+            /**
+             * @brief Fill the bit buffer with at least 56 bits.
+             * @details With 8 bytes of input left, the next 8 bytes are loaded at once, and the whole bytes that fit in the
+             * buffer are consumed. The bits of the following byte that also fit are the same as will be loaded with it.
+             * @return false if more padding has been added than fits in the buffer, i.e. the input is truncated.
+             */
+            bool refill()
+            {
+                if (inEnd - in >= 8) {
+#if MINIZ_LITTLE_ENDIAN
+                    uint64_t value = 0;
+                    std::memcpy(&value, in, sizeof value);
+#else
+                    uint64_t value = MZ_READ_LE64(in);
+#endif
+                    bits |= value << count;
+                    in += (63 - count) >> 3;
+                    count |= 56;
+                    return true;
+                }
+
+                for (; count < 56; count += 8) {
+                    if (in < inEnd)
+                        bits |= uint64_t { *in++ } << count;
+                    else if (++overrun > 8)
+                        return false;
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief Check if any of the padding past the end of the input has been consumed.
+             */
+            bool isOverrun() const { return overrun * 8 > count; }
+
+            uint32_t peek(unsigned length) const { return static_cast<uint32_t>(bits & ((uint64_t { 1 } << length) - 1)); }
+
+            void consume(unsigned length)
+            {
+                bits >>= length;
+                count -= length;
+            }
+
+            uint32_t take(unsigned length)
+            {
+                auto value = peek(length);
+                consume(length);
+                return value;
+            }
+
+            /**
+             * @brief Decode a symbol, consuming its code and its extra bits at once.
+             * @details The extra bits are extracted afterwards from the saved bit buffer (see extraValue), which keeps them
+             * out of the dependency chain from one table lookup to the next.
+             * @return The table entry of the symbol.
+             */
+            uint32_t decode(const uint32_t* table, unsigned tableBits)
+            {
+                auto entry = table[peek(tableBits)];
+                if (entryKind(entry) == Subtable) {
+                    consume(entryBits(entry));
+                    entry = table[entryPayload(entry) + peek(entryExtraBits(entry))];
+                }
+                saved = bits;
+                consume(entryBits(entry));
+
+                return entry;
+            }
+
+            /**
+             * @brief Get the value of the extra bits of the last decoded entry.
+             */
+            uint32_t extraValue(uint32_t entry) const
+            {
+                auto extraBits = entryExtraBits(entry);
+                return static_cast<uint32_t>(saved >> (entryBits(entry) - extraBits)) & ((1U << extraBits) - 1);
+            }
+        };
+
+        /**
+         * @brief The FastInflater class decompresses a raw deflate stream from memory to memory.
+         * @details Literals with short codes are decoded two at a time (see buildInflateTable), and matches are copied in
+         * 16 byte chunks, where the chunks may extend past the end of the match. Matches with a distance shorter than a
+         * chunk are first expanded by doubling the distance.
+         */
+        class FastInflater
+        {
+        public:
+            FastInflater(const unsigned char* source, std::size_t sourceSize, unsigned char* destination, std::size_t destinationSize)
+                : m_reader { source, source + sourceSize },
+                  m_outStart(destination),
+                  m_out(destination),
+                  m_outEnd(destination + destinationSize)
+            {}
+
+            /**
+             * @brief Decompress the stream.
+             * @return The number of bytes decompressed, or TINFL_DECOMPRESS_MEM_TO_MEM_FAILED on failure.
+             */
+            std::size_t run()
+            {
+                thread_local InflateTables tables;
+
+                auto isFinal = false;
+                while (!isFinal) {
+                    if (!m_reader.refill() || m_reader.isOverrun()) return TINFL_DECOMPRESS_MEM_TO_MEM_FAILED;
+                    isFinal   = m_reader.take(1) != 0;
+                    auto type = m_reader.take(2);
+
+                    auto isValid = false;
+                    if (type == 0)
+                        isValid = copyStored();
+                    else if (type == 1)
+                        isValid = decodeBlock(fixedTables());
+                    else if (type == 2)
+                        isValid = readTables(tables) && decodeBlock(tables);
+                    if (!isValid) return TINFL_DECOMPRESS_MEM_TO_MEM_FAILED;
+                }
+
+                if (m_reader.isOverrun()) return TINFL_DECOMPRESS_MEM_TO_MEM_FAILED;
+                return static_cast<std::size_t>(m_out - m_outStart);
+            }
+
+        private:
+            /**
+             * @brief Get the decoding tables for blocks compressed with the fixed Huffman codes.
+             */
+            static const InflateTables& fixedTables()
+            {
+                static const auto tables = []() {
+                    auto    result = std::make_unique<InflateTables>();
+                    uint8_t lengths[288];
+                    std::fill(lengths, lengths + 144, uint8_t { 8 });
+                    std::fill(lengths + 144, lengths + 256, uint8_t { 9 });
+                    std::fill(lengths + 256, lengths + 280, uint8_t { 7 });
+                    std::fill(lengths + 280, lengths + 288, uint8_t { 8 });
+                    buildInflateTable(lengths, 288, InflateSymbol.litlen.data(), result->litlen.data(), LitlenTableBits, true);
+                    std::fill(lengths, lengths + 32, uint8_t { 5 });
+                    buildInflateTable(lengths, 32, InflateSymbol.dist.data(), result->dist.data(), DistTableBits, false);
+                    return result;
+                }();
+
+                return *tables;
+            }
+
+            /**
+             * @brief Copy a stored block.
+             * @details The whole bytes left in the bit buffer are returned to the input first, after which the block is
+             * copied directly from the input.
+             */
+            bool copyStored()
+            {
+                auto& reader = m_reader;
+                reader.consume(reader.count & 7);
+                auto buffered = reader.count >> 3;
+                if (buffered < reader.overrun) return false;
+                reader.in -= buffered - reader.overrun;
+                reader = InflateBitReader { reader.in, reader.inEnd };
+
+                if (reader.inEnd - reader.in < 4) return false;
+                auto length = static_cast<std::size_t>(MZ_READ_LE16(reader.in));
+                if (length != (~MZ_READ_LE16(reader.in + 2) & 0xFFFFU)) return false;
+                reader.in += 4;
+
+                if (static_cast<std::size_t>(reader.inEnd - reader.in) < length || static_cast<std::size_t>(m_outEnd - m_out) < length) return false;
+                if (length > 0) std::memcpy(m_out, reader.in, length);
+                reader.in += length;
+                m_out += length;
+
+                return true;
+            }
+
+            /**
+             * @brief Read the code lengths of a block compressed with dynamic Huffman codes, and build its decoding tables.
+             */
+            bool readTables(InflateTables& tables)
+            {
+                constexpr uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+                auto& reader = m_reader;
+                if (!reader.refill()) return false;
+                auto litlenCount     = reader.take(5) + 257;
+                auto distCount       = reader.take(5) + 1;
+                auto codeLengthCount = reader.take(4) + 4;
+
+                uint8_t codeLengths[19] = {};
+                for (uint32_t i = 0; i < codeLengthCount; ++i) {
+                    if (!reader.refill()) return false;
+                    codeLengths[order[i]] = static_cast<uint8_t>(reader.take(3));
+                }
+                auto* codeLengthTable = tables.codeLength.data();
+                if (!buildInflateTable(codeLengths, 19, InflateSymbol.codeLength.data(), codeLengthTable, CodeLengthTableBits, false)) return false;
+
+                // ===== Symbols 16-18 repeat the previous length, or zero, a number of times given by the extra bits.
+                uint8_t lengths[288 + 32];
+                auto    total = litlenCount + distCount;
+                for (uint32_t count = 0; count < total;) {
+                    if (!reader.refill()) return false;
+                    auto entry = reader.decode(codeLengthTable, CodeLengthTableBits);
+                    if (entryKind(entry) != Literal) return false;
+
+                    auto symbol = entryPayload(entry);
+                    if (symbol < 16) {
+                        lengths[count++] = static_cast<uint8_t>(symbol);
+                        continue;
+                    }
+                    if (symbol == 16 && count == 0) return false;
+
+                    auto repeat = symbol == 16 ? 3 + reader.take(2) : symbol == 17 ? 3 + reader.take(3) : 11 + reader.take(7);
+                    if (count + repeat > total) return false;
+                    std::fill(lengths + count, lengths + count + repeat, symbol == 16 ? lengths[count - 1] : uint8_t { 0 });
+                    count += repeat;
+                }
+
+                return buildInflateTable(lengths, litlenCount, InflateSymbol.litlen.data(), tables.litlen.data(), LitlenTableBits, true) &&
+                       buildInflateTable(lengths + litlenCount, distCount, InflateSymbol.dist.data(), tables.dist.data(), DistTableBits, false);
+            }
+
+            /**
+             * @brief Decode the symbols of a Huffman compressed block, up to and including the end of block symbol.
+             * @details The bit reader and the output position are kept in local variables while decoding, as the compiler
+             * can't keep members in registers across the stores to the output.
+             */
+            bool decodeBlock(const InflateTables& tables)
+            {
+                const auto* litlen   = tables.litlen.data();
+                const auto* dist     = tables.dist.data();
+                auto        reader   = m_reader;
+                auto*       out      = m_out;
+                auto* const outStart = m_outStart;
+                auto* const outEnd   = m_outEnd;
+                auto        isValid  = false;
+
+                while (true) {
+                    // ===== After a refill, the buffer holds at least 56 bits, which covers the longest length/distance
+                    // pair: 15 + 5 bits for the length and 15 + 13 bits for the distance.
+                    if (!reader.refill()) break;
+                    auto entry = reader.decode(litlen, LitlenTableBits);
+                    auto kind  = entryKind(entry);
+
+                    // ===== Literals are decoded without refilling for as long as the buffer holds a complete code,
+                    // including the extra bits of a length. Two bytes are written at once where there is room, also for a
+                    // single literal.
+                    while (kind <= DoubleLiteral) {
+                        if (outEnd - out >= 2) {
+                            out[0] = static_cast<unsigned char>(entryPayload(entry));
+                            out[1] = static_cast<unsigned char>(entryPayload(entry) >> 8);
+                        }
+                        else if (kind == Literal && out != outEnd)
+                            out[0] = static_cast<unsigned char>(entryPayload(entry));
+                        else {
+                            kind = Invalid;
+                            break;
+                        }
+                        out += kind + 1;
+                        if (reader.count < MaxCodeBits + 5) break;
+                        entry = reader.decode(litlen, LitlenTableBits);
+                        kind  = entryKind(entry);
+                    }
+                    if (kind <= DoubleLiteral) continue;
+                    if (kind != Length) {
+                        isValid = kind == EndOfBlock;
+                        break;
+                    }
+
+                    // ===== The distance and its extra bits take at most 15 + 13 bits.
+                    auto length = entryPayload(entry) + reader.extraValue(entry);
+                    if (reader.count < 28 && !reader.refill()) break;
+                    entry = reader.decode(dist, DistTableBits);
+                    if (entryKind(entry) != Distance) break;
+                    auto distance = entryPayload(entry) + reader.extraValue(entry);
+
+                    if (distance > static_cast<std::size_t>(out - outStart) || length > static_cast<std::size_t>(outEnd - out)) break;
+                    out = copyMatch(out, distance, length, outEnd);
+                }
+
+                m_reader = reader;
+                m_out    = out;
+                return isValid;
+            }
+
+            /**
+             * @brief Copy a match from earlier in the output.
+             * @details Matches are copied in 16 byte chunks, which may extend past the end of the match, as long as there
+             * is room in the output. Each 8 byte load is done after the previous store, so a distance of 8-15 bytes is
+             * copied correctly.
+             * @return The end of the match.
+             */
+            static unsigned char* copyMatch(unsigned char* out, std::size_t distance, std::size_t length, unsigned char* outEnd)
+            {
+                auto* const end = out + length;
+                if (distance < 8 || outEnd - end < 16) return copyShortMatch(out, distance, length, outEnd);
+
+                const auto* source = out - distance;
+                do {
+                    uint64_t chunk = 0;
+                    std::memcpy(&chunk, source, 8);
+                    std::memcpy(out, &chunk, 8);
+                    std::memcpy(&chunk, source + 8, 8);
+                    std::memcpy(out + 8, &chunk, 8);
+                    out += 16;
+                    source += 16;
+                } while (out < end);
+
+                return end;
+            }
+
+            /**
+             * @brief Copy a match with a distance shorter than 8 bytes, or near the end of the output.
+             * @details Near the end of the output, the match is copied byte by byte, so as not to write past the end.
+             * Otherwise, the match is repeated until the distance from the source is at least 8 bytes, after which it is
+             * copied in chunks. As the output is periodic with the distance, it is also periodic with any multiple of it.
+             * @return The end of the match.
+             */
+            static unsigned char* copyShortMatch(unsigned char* out, std::size_t distance, std::size_t length, unsigned char* outEnd)
+            {
+                const auto* source = out - distance;
+                auto* const end    = out + length;
+                if (outEnd - end < 16) {
+                    for (std::size_t i = 0; i < length; ++i) out[i] = source[i];
+                    return end;
+                }
+
+                if (distance == 1) {
+                    std::memset(out, *source, length);
+                    return end;
+                }
+
+                while (out - source < 8) {
+                    uint64_t chunk = 0;
+                    std::memcpy(&chunk, source, 8);
+                    std::memcpy(out, &chunk, 8);
+                    out += out - source;
+                }
+
+                return out >= end ? end : copyMatch(out, static_cast<std::size_t>(out - source), static_cast<std::size_t>(end - out), outEnd);
+            }
+
+            InflateBitReader m_reader;   /**< The reader of the input. */
+            unsigned char*   m_outStart; /**< The start of the output. */
+            unsigned char*   m_out;      /**< The next byte of output. */
+            unsigned char*   m_outEnd;   /**< The end of the output. */
+        };
+    }    // namespace
+
+    std::size_t inflateBuffer(ZipInflateEngine engine, const unsigned char* source, std::size_t sourceSize, unsigned char* destination, std::size_t destinationSize)
+    {
+        if (engine == ZipInflateEngine::Miniz) return tinfl_decompress_mem_to_mem(destination, destinationSize, source, sourceSize, 0);
+
+        return FastInflater(source, sourceSize, destination, destinationSize).run();
+    }
+
+} // namespace KZip::Impl
+
+namespace KZip {
+
+    ZipArchive::ZipArchive() = default;
+
+    ZipArchive::ZipArchive(const fs::path& fileName, OpenMode mode)
+    {
+        // ===== If successful, continue to open the file.
+        if (fs::exists(fileName)) open(fileName, mode);
+
+        // ===== If unsuccessful, create the archive file and continue.
+        else {
+            m_archive->m_openMode = mode;
+            create(fileName);
+        }
+    }
+
+    ZipArchive::ZipArchive(ZipArchive&& other) noexcept = default;
+
+    ZipArchive::~ZipArchive() { close(); }
+
+    ZipArchive& ZipArchive::operator=(ZipArchive&& other) noexcept = default;
+
+    void ZipArchive::create(const fs::path& fileName) { m_archive->create(fileName); }
+
+    void ZipArchive::open(const fs::path& fileName, OpenMode mode, std::size_t threadCount) { m_archive->open(fileName, mode, threadCount); }
+
+    void ZipArchive::close() { m_archive->close(); }
+
+    bool ZipArchive::isOpen() const { return m_archive->isOpen(); }
+
+    std::vector<std::string> ZipArchive::entryNames(ZipFlags flags) const
+    {
+        return m_archive->entryNames(flags);
+    }
+
+    std::vector<std::string> ZipArchive::entryNames(const std::string& path, ZipFlags flags) const
+    {
+        return m_archive->entryNames(path, flags);
+    }
+
+    uint64_t ZipArchive::entryCount(ZipFlags flags)
+    {
+        return m_archive->entryCount(flags);
+    }
+
+    uint64_t ZipArchive::entryCount(const std::string& path, ZipFlags flags)
+    {
+        return m_archive->entryCount(path, flags);
+    }
+
+    ZipEntryRange ZipArchive::entries(ZipFlags flags) { return m_archive->entries("", flags); }
+
+    ZipEntryRange ZipArchive::entries(std::string_view path, ZipFlags flags) { return m_archive->entries(path, flags); }
+
+    ZipEntryRange ZipArchive::find(std::string_view pattern, ZipFlags flags) { return m_archive->find(pattern, flags); }
+
+    bool ZipArchive::hasEntry(const std::string& entryName) const { return m_archive->hasEntry(entryName); }
+
+    uint64_t ZipArchive::shadowedEntryCount() const { return m_archive->shadowedEntryCount(); }
+
+    void ZipArchive::setCacheSize(std::size_t capacity) { m_archive->setCacheSize(capacity); }
+
+    ZipCacheStatistics ZipArchive::cacheStatistics() const { return m_archive->cacheStatistics(); }
+
+    void ZipArchive::clearCache() { m_archive->clearCache(); }
+
+    void ZipArchive::setSeekInterval(uint64_t interval) { m_archive->setSeekInterval(interval); }
+
+    void ZipArchive::setVerification(ZipVerification verification) { m_archive->setVerification(verification); }
+
+    ZipVerification ZipArchive::verification() const { return m_archive->verification(); }
+
+    void ZipArchive::setInflateEngine(ZipInflateEngine engine) { m_archive->setInflateEngine(engine); }
+
+    ZipInflateEngine ZipArchive::inflateEngine() const { return m_archive->inflateEngine(); }
 
     void ZipArchive::save(const fs::path& filename) {
         m_archive->save(filename); }
 
+    void ZipArchive::extractAll(const fs::path& directory, const ZipExtractOptions& options) const { m_archive->extractAll(directory, options); }
+
+    void ZipArchive::extract(const std::vector<std::string>& names, const ZipEntrySink& sink) const { m_archive->extract(names, sink); }
+
+    std::future<void> ZipArchive::extractAsync(const std::vector<std::string>& names, ZipEntrySink sink, std::size_t threadCount) const
+    {
+        return m_archive->extractAsync(names, std::move(sink), threadCount);
+    }
+
     void ZipArchive::deleteEntry(const std::string& name) { m_archive->deleteEntry(name); }
 
     ZipEntryProxy& ZipArchive::entry(const std::string& path) { return m_archive->entry(path); }
@@ -17,17 +17,34 @@
 
 // ===== Standard Includes =====
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <random>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -81,8 +98,69 @@ namespace KZip
 
     namespace Impl
     {
-        class ZipEntryWrapper;
         class ZipArchive;
+        class ZipGlob;
+
+        /**
+         * @brief The ZipEntryRecord struct is the compact, per-entry record in the entry table of an archive.
+         * @details The record holds the metadata required for reading and writing the entry. The entry name is not
+         * stored in the record itself, but in a name arena shared by all entries in the archive, which the record refers
+         * to by offset and length. This keeps the record at a fixed 64 bytes, as opposed to the more than 1 KB required
+         * for a mz_zip_archive_file_stat struct.
+         */
+        struct ZipEntryRecord
+        {
+            uint64_t localHeaderOffset { 0 }; /**< The offset of the local header in the archive file. */
+            uint64_t compressedSize { 0 };    /**< The compressed size of the entry. */
+            uint64_t uncompressedSize { 0 };  /**< The uncompressed size of the entry. */
+            uint64_t nameOffset { 0 };        /**< The offset of the entry name in the name arena. */
+            time_t   time { 0 };              /**< The modification time of the entry. */
+            uint32_t nameLength { 0 };        /**< The length of the entry name. */
+            uint32_t fileIndex { 0 };         /**< The index of the entry in the archive file. */
+            uint32_t crc32 { 0 };             /**< The CRC-32 checksum of the uncompressed data. */
+            uint16_t method { 0 };            /**< The compression method. */
+            bool     isDirectory { false };   /**< true if the entry is a directory. */
+            bool     isEncrypted { false };   /**< true if the entry is encrypted. */
+            bool     isSupported { true };    /**< true if the entry can be extracted by miniz. */
+            bool     isInArchive { false };   /**< true if the entry exists in the archive file (i.e. it is not a new entry). */
+            bool     isLoaded { true };       /**< true if the metadata has been read from the archive file (see OpenMode::Lazy). */
+            bool     isDeleted { false };     /**< true if the entry has been deleted (see ZipArchive::deleteEntry). */
+            bool     isVerified { false };    /**< true if the checksum of the entry data has been verified (see ZipVerification::FirstRead). */
+        };
+
+        /**
+         * @brief The Crc32Engine enum identifies the implementations of the CRC-32 checksum used by the zip format.
+         * @details All implementations compute the same checksum. mz_crc32() (and thereby all reads and writes of entry
+         * data) uses the fastest implementation supported by the CPU, which is selected on first use (see crc32Engine).
+         */
+        enum class Crc32Engine : uint8_t {
+            Bytewise,  /**< One table lookup per byte, as in miniz. Used as reference. */
+            SliceBy16, /**< Sixteen table lookups per 16 bytes. Available on all CPUs. */
+            Clmul,     /**< Folding with carry-less multiplication (PCLMULQDQ) on x86 CPUs with SSE4.1. */
+            ArmCrc     /**< The CRC32 instructions of ARMv8 CPUs. */
+        };
+
+        /**
+         * @brief Check if a CRC-32 implementation is supported by the CPU.
+         * @param engine The implementation.
+         * @return true if it can be used; otherwise false.
+         */
+        bool isSupported(Crc32Engine engine);
+
+        /**
+         * @brief Get the CRC-32 implementation used by mz_crc32(), i.e. the fastest one supported by the CPU.
+         */
+        Crc32Engine crc32Engine();
+
+        /**
+         * @brief Update a CRC-32 checksum with a block of data, using the given implementation.
+         * @param engine The implementation. It must be supported by the CPU (see isSupported).
+         * @param crc The checksum of the preceding data, or 0 (MZ_CRC32_INIT) for the first block.
+         * @param data The data.
+         * @param size The size of the data.
+         * @return The checksum including the data.
+         */
+        uint32_t updateCrc32(Crc32Engine engine, uint32_t crc, const unsigned char* data, std::size_t size);
     }    // namespace Impl
 
 
@@ -115,30 +193,198 @@ namespace KZip
     }
 
     /**
-     * @brief The ZipEntryMetaData is essentially a wrapper around the ZipEntryInfo struct, which is an alias for a
-     * miniz struct.
+     * @brief The OpenMode enum is used to select how an archive is opened.
+     * @details The values are flags, which can be combined using the | operator.
+     */
+    enum class OpenMode : uint8_t {
+        Default = 0, /**< Read the metadata of all entries when the archive is opened. */
+        Lazy    = 1, /**< Only index the entry names when the archive is opened. The metadata of an entry is read on first access. */
+        Indexed = 2, /**< Keep the entry table of the archive in a sidecar index file (the archive filename with ".kzidx"
+                          appended), and load it from there when the archive is opened, as long as the archive is unchanged. */
+        MemoryMapped = 4, /**< Map the archive file into memory, and read entries from the mapping instead of through file
+                               I/O. If the file can't be mapped, it is read as usual. */
+        Concurrent = 8 /**< Allow entries to be read from multiple threads at once (see ZipArchive::open). The archive file
+                            is read using positional reads, and the internal bookkeeping is protected by a lock. */
+    };
+
+    /**
+     * @brief
+     * @param first
+     * @param second
+     * @return
+     */
+    inline OpenMode operator|(OpenMode first, OpenMode second)
+    {
+        return static_cast<OpenMode>(static_cast<uint8_t>(first) | static_cast<uint8_t>(second));
+    }
+
+    /**
+     * @brief
+     * @param first
+     * @param second
+     * @return
+     */
+    inline OpenMode operator&(OpenMode first, OpenMode second)
+    {
+        return static_cast<OpenMode>(static_cast<uint8_t>(first) & static_cast<uint8_t>(second));
+    }
+
+    /**
+     * @brief The ZipVerification enum selects when the CRC-32 checksum of the entry data is verified as entries are read.
+     * @details The policy applies to complete reads of entries in the archive file (e.g. getData(), readInto(),
+     * openStream(), extract() and extractAll()). Data returned from the cache, and the data of new or modified entries,
+     * is never verified. A failed verification throws a ZipRuntimeError.
+     */
+    enum class ZipVerification : uint8_t {
+        Default   = 0, /**< Use the policy of the archive (see ZipArchive::setVerification). */
+        Always    = 1, /**< Verify the checksum on every read. This is the default policy of an archive. */
+        FirstRead = 2, /**< Verify the checksum until an entry has been read and verified once, e.g. for archives that are
+                            read repeatedly. The result is kept per entry for as long as the archive is open. */
+        Never     = 3  /**< Don't verify the checksum, e.g. for archives that were just written or verified by the caller. */
+    };
+
+    /**
+     * @brief The ZipInflateEngine enum selects the implementation used for decompressing deflated entries in one go, i.e.
+     * by getData(), readInto(), extract() and extractAsync().
+     * @details Both implementations produce the same output for every valid deflate stream. Reads that decompress an
+     * entry in chunks (openStream(), read() and extractAll()) always use miniz.
+     */
+    enum class ZipInflateEngine : uint8_t {
+        Miniz = 0, /**< tinfl_decompress() of miniz, which decodes one symbol per table lookup. */
+        Fast  = 1  /**< The decompressor of KZip (see Impl::inflateBuffer), which uses a 64-bit bit buffer, decodes two literals
+                        per table lookup when their codes are short enough, and copies matches in 16 byte chunks. This is
+                        the default. */
+    };
+
+    /**
+     * @brief The ZipCacheStatistics struct holds the usage statistics of the cache of decompressed entry data of an archive
+     * (see ZipArchive::setCacheSize).
+     */
+    struct ZipCacheStatistics
+    {
+        uint64_t    hits { 0 };       /**< The number of reads served from the cache. */
+        uint64_t    misses { 0 };     /**< The number of reads that had to decompress the entry. */
+        std::size_t size { 0 };       /**< The number of bytes currently held in the cache. */
+        std::size_t capacity { 0 };   /**< The maximum number of bytes held in the cache. */
+        std::size_t entryCount { 0 }; /**< The number of entries currently held in the cache. */
+    };
+
+    /**
+     * @brief The ZipExtractOptions struct holds the options for extracting all entries of an archive (see ZipArchive::extractAll).
+     */
+    struct ZipExtractOptions
+    {
+        std::size_t threadCount { 0 };  /**< The number of threads to extract entries on. If zero, the number of hardware threads is used. */
+        bool        overwrite { true }; /**< If false, files that already exist in the target directory are left unchanged. */
+    };
+
+    /**
+     * @brief The callback receiving the data of each entry extracted by ZipArchive::extract. The data is only valid
+     * during the call.
+     */
+    using ZipEntrySink = std::function<void(std::string_view name, const std::vector<unsigned char>& data)>;
+
+    /**
+     * @brief The ZipByteView class is a read-only view of a contiguous sequence of bytes held elsewhere, such as entry
+     * data in a memory mapped archive (see ZipEntryProxy::view).
+     */
+    class ZipByteView
+    {
+    public:
+        ZipByteView() = default;
+        ZipByteView(const unsigned char* data, std::size_t size) : m_data(data), m_size(size) {}
+
+        const unsigned char* data() const { return m_data; }
+        std::size_t          size() const { return m_size; }
+        bool                 empty() const { return m_size == 0; }
+        const unsigned char* begin() const { return m_data; }
+        const unsigned char* end() const { return m_data + m_size; }
+        unsigned char        operator[](std::size_t index) const { return m_data[index]; }
+
+    private:
+        const unsigned char* m_data = nullptr; /**< The first byte. */
+        std::size_t          m_size { 0 };     /**< The number of bytes. */
+    };
+
+    /**
+     * @brief The ZipCompressedData class holds the data of an entry as it is stored in the archive file, i.e. without
+     * decompressing it, along with the compression method, checksum and size of the uncompressed data (see
+     * ZipEntryProxy::rawCompressed).
+     * @details For deflated entries (method 8), the data is a raw deflate stream (RFC 1951), without zlib or gzip
+     * wrapping; the checksum and the uncompressed size are what a gzip trailer needs. For stored entries (method 0), the
+     * data is the entry data itself.
+     *
+     * If the archive is memory mapped, the data refers directly to the mapping, and for new or modified entries it refers
+     * to the data held by the entry; in both cases nothing is copied. Otherwise, the data is read into a buffer held by
+     * the object.
+     * @note Data that isn't held by the object is valid until the archive is closed or saved, or the entry is modified.
+     */
+    class ZipCompressedData
+    {
+        friend class Impl::ZipArchive;
+        friend class ZipEntryProxy;
+
+    public:
+        const unsigned char* data() const { return m_data ? m_data : m_buffer.data(); }
+        std::size_t          size() const { return static_cast<std::size_t>(m_size); }
+        uint16_t             method() const { return m_method; }
+        uint32_t             crc32() const { return m_crc32; }
+        uint64_t             uncompressedSize() const { return m_uncompressedSize; }
+        bool                 isCopy() const { return !m_data && m_size > 0; }
+
+    private:
+        const unsigned char*       m_data = nullptr;       /**< The data, if not held by the object. */
+        std::vector<unsigned char> m_buffer = {};          /**< The data, if read from the archive file. */
+        uint64_t                   m_size { 0 };           /**< The size of the data. */
+        uint64_t                   m_uncompressedSize { 0 };    /**< The size of the uncompressed data. */
+        uint32_t                   m_crc32 { 0 };          /**< The CRC-32 checksum of the uncompressed data. */
+        uint16_t                   m_method { 0 };         /**< The compression method (0 = stored, 8 = deflated). */
+    };
+
+    /**
+     * @brief The ZipEntryMetaData class gives read access to the metadata of an entry, i.e. the information held in the
+     * entry record of the archive.
+     * @note The name refers to storage held by the archive (or by the ZipEntry object the metadata was taken from). It
+     * remains valid until the archive is modified.
      */
     class ZipEntryMetaData
     {
     public:
         /**
          * @brief Constructor.
-         * @param info A reference to a ZipEntryInfo object.
+         * @param record A reference to the entry record.
+         * @param name The name of the entry.
+         */
+        ZipEntryMetaData(const Impl::ZipEntryRecord& record, std::string_view name) : m_record(record), m_name(name) {}
+
+        /**
+         * @brief Constructor.
+         * @param info A reference to a mz_zip_archive_file_stat object.
          */
-        explicit ZipEntryMetaData(const mz_zip_archive_file_stat& info) : m_stats(info) {}
+        explicit ZipEntryMetaData(const mz_zip_archive_file_stat& info) : m_name(info.m_filename)
+        {
+            m_record.fileIndex        = info.m_file_index;
+            m_record.compressedSize   = info.m_comp_size;
+            m_record.uncompressedSize = info.m_uncomp_size;
+            m_record.isDirectory      = info.m_is_directory;
+            m_record.isEncrypted      = info.m_is_encrypted;
+            m_record.isSupported      = info.m_is_supported;
+            m_record.time             = info.m_time;
+        }
 
-        uint32_t         index() const { return m_stats.m_file_index; }
-        uint64_t         compressedSize() const { return m_stats.m_comp_size; }
-        uint64_t         uncompressedSize() const { return m_stats.m_uncomp_size; }
-        bool             isDirectory() const { return m_stats.m_is_directory; }
-        bool             isEncrypted() const { return m_stats.m_is_encrypted; }
-        bool             isSupported() const { return m_stats.m_is_supported; }
-        std::string_view name() const { return m_stats.m_filename; }
+        uint32_t         index() const { return m_record.fileIndex; }
+        uint64_t         compressedSize() const { return m_record.compressedSize; }
+        uint64_t         uncompressedSize() const { return m_record.uncompressedSize; }
+        bool             isDirectory() const { return m_record.isDirectory; }
+        bool             isEncrypted() const { return m_record.isEncrypted; }
+        bool             isSupported() const { return m_record.isSupported; }
+        std::string_view name() const { return m_name; }
 //        std::string_view comment() const { return m_stats.m_comment; }
-        time_t           time() const { return m_stats.m_time; }
+        time_t           time() const { return m_record.time; }
 
     private:
-        mz_zip_archive_file_stat m_stats;
+        Impl::ZipEntryRecord m_record = {};
+        std::string_view     m_name   = {};
     };
 
     /**
@@ -306,9 +552,131 @@ namespace KZip
         std::vector<unsigned char> m_data = {};
     };
 
+    /**
+     * @brief The ZipEntryReader class reads the data of an entry sequentially, in chunks of any size chosen by the caller.
+     * @details The entry is decompressed incrementally, so the memory used is bounded by the size of the decompression
+     * window and a fixed-size read buffer, regardless of the size of the entry. When the last chunk has been read, the
+     * size and CRC-32 checksum of the data are verified.
+     *
+     * ZipEntryReader objects are created by ZipEntryProxy::openStream(). For use with the standard library streams,
+     * see ZipEntryStream. Readers created by ZipEntryProxy::openRawStream() read the compressed data as stored in the
+     * archive file instead; nothing is decompressed or verified.
+     * @note The reader is invalidated if the archive is closed or saved, or if the data of the entry is changed.
+     */
+    class ZipEntryReader
+    {
+        friend class ZipEntryProxy;
+
+    public:
+        ZipEntryReader(const ZipEntryReader& other) = delete;
+        ZipEntryReader(ZipEntryReader&& other) noexcept;
+        ZipEntryReader& operator=(const ZipEntryReader& other) = delete;
+        ZipEntryReader& operator=(ZipEntryReader&& other) noexcept;
+        ~ZipEntryReader();
+
+        /**
+         * @brief Read the next chunk of data.
+         * @param buffer The buffer to read into.
+         * @param size The size of the buffer. Fewer bytes are only read when the end of the entry is reached.
+         * @return The number of bytes read, or zero when all data has been read.
+         * @throw ZipRuntimeError if the data can't be read or decompressed, or if the checksum doesn't match.
+         * @throw ZipLogicError if a previous read has failed.
+         */
+        std::size_t read(void* buffer, std::size_t size);
+
+        /**
+         * @brief Get the size of the data read, i.e. the uncompressed size of the entry, or the compressed size for raw
+         * readers.
+         * @return The size in bytes.
+         */
+        uint64_t size() const { return m_size; }
+
+        /**
+         * @brief Get the number of bytes read so far.
+         * @return The position in the entry data.
+         */
+        uint64_t position() const { return m_position; }
+
+        /**
+         * @brief Check if all data has been read.
+         * @return true if the end of the entry has been reached; otherwise false.
+         */
+        bool eof() const { return m_position == m_size; }
+
+    private:
+        ZipEntryReader(mz_zip_archive* archive, const mz_zip_archive_file_stat& info, mz_uint flags = 0);
+        ZipEntryReader(const unsigned char* data, uint64_t size);
+
+        void finish();
+
+        mz_zip_archive*                   m_archive = nullptr; /**< The archive, if the entry is read from the archive file. */
+        mz_zip_reader_extract_iter_state* m_state   = nullptr; /**< The miniz extraction state, until all data is read. */
+        const unsigned char*              m_data    = nullptr; /**< The data, if the entry is read from memory (i.e. a new entry). */
+        uint64_t                          m_size { 0 };        /**< The size of the entry. */
+        uint64_t                          m_position { 0 };    /**< The number of bytes read. */
+        bool                              m_isFailed { false }; /**< true if reading or decompressing the data has failed. */
+    };
+
+    /**
+     * @brief The ZipEntryStream class is an input stream reading the data of an entry through a ZipEntryReader.
+     * @details The data is read into a fixed-size window, so the memory used doesn't depend on the size of the entry.
+     * Errors while reading set the badbit of the stream (or throw, if enabled through the exceptions() function).
+     */
+    class ZipEntryStream : public std::istream
+    {
+    public:
+        static constexpr std::size_t DefaultWindowSize = 64 * 1024; /**< The default size of the read window. */
+
+        /**
+         * @brief Constructor.
+         * @param reader The reader to read the entry data from, typically returned by ZipEntryProxy::openStream().
+         * @param windowSize The size of the read window.
+         */
+        explicit ZipEntryStream(ZipEntryReader reader, std::size_t windowSize = DefaultWindowSize);
+
+        ZipEntryStream(const ZipEntryStream& other) = delete;
+        ZipEntryStream& operator=(const ZipEntryStream& other) = delete;
+        ~ZipEntryStream() override;
+
+    private:
+        class Buffer : public std::streambuf
+        {
+        public:
+            Buffer(ZipEntryReader reader, std::size_t windowSize);
+
+        protected:
+            int_type underflow() override;
+
+        private:
+            ZipEntryReader    m_reader;      /**< The reader of the entry data. */
+            std::vector<char> m_window = {}; /**< The read window. */
+        };
+
+        Buffer m_buffer; /**< The stream buffer. */
+    };
+
+    namespace Impl
+    {
+        template<typename T, typename = void>
+        struct IsByteContainer : std::false_type
+        {
+        };
+
+        template<typename T>
+        struct IsByteContainer<T, std::void_t<decltype(std::declval<T&>().data()), decltype(std::declval<T&>().resize(std::size_t {}))>>
+            : std::bool_constant<sizeof(typename T::value_type) == 1 && std::is_trivially_copyable_v<typename T::value_type>>
+        {
+        };
+    }    // namespace Impl
+
+    /**
+     * @brief true if T is a contiguous, resizable container of single byte elements, that entry data can be extracted into.
+     */
+    template<typename T>
+    inline constexpr bool isByteContainer = Impl::IsByteContainer<T>::value;
+
     class ZipEntryProxy {
         friend class Impl::ZipArchive;
-        friend class Impl::ZipEntryWrapper;
     public:
 
         /**
@@ -350,6 +718,8 @@ namespace KZip
             else {
                 m_data = std::vector<unsigned char> {data.begin(), data.end()};
             }
+
+            uncache();
         }
 
         /**
@@ -360,43 +730,20 @@ namespace KZip
          * @note While any iterator-based container with an unsigned char value type can be used,
          * the function is optimized for std::string and std::vector<unsigned char>
          * @tparam T The type to convert to (e.g. std::string or std::vector<unsigned char>
+         * @param verification The checksum verification policy for the read (see ZipVerification).
          * @return An object of type T, holding the zip data.
          */
         template<typename T, typename std::enable_if<std::is_convertible_v<typename T::value_type, unsigned char>>::type* = nullptr>
-        T getData() const
+        T getData(ZipVerification verification = ZipVerification::Default) const
         {
             if (m_data.has_value())
                 return {m_data->begin(), m_data->end()};
 
-            // ===== Optimization for std::string
-            if constexpr (std::is_same_v<T, std::string>) {
-
-                // ===== Create a temporary vector of unsinged char, to hold the zip data
-                std::string data;
-                data.resize(m_info.m_uncomp_size);
-                mz_zip_reader_extract_to_mem(m_archive, m_info.m_file_index, data.data(), m_info.m_uncomp_size, 0);
-
-                // ===== Check that the operation was successful
-                if (!m_info.m_is_directory && data.size() != m_info.m_uncomp_size) {
-                    throw ZipRuntimeError(mz_zip_get_error_string(m_archive->m_last_error));
-                }
-
-                return data;
-            }
-
-            // ===== Optimization for std::vector<unsigned char>
-            else if constexpr (std::is_same_v<T, std::vector<unsigned char>>) {
-
-                // ===== Create a temporary vector of unsinged char, to hold the zip data
-                std::vector<unsigned char> data;
-                data.resize(m_info.m_uncomp_size);
-                mz_zip_reader_extract_to_mem(m_archive, m_info.m_file_index, data.data(), m_info.m_uncomp_size, 0);
-
-                // ===== Check that the operation was successful
-                if (!m_info.m_is_directory && data.size() != m_info.m_uncomp_size) {
-                    throw ZipRuntimeError(mz_zip_get_error_string(m_archive->m_last_error));
-                }
-
+            // ===== Optimization for contiguous containers of bytes (e.g. std::string and std::vector<unsigned char>),
+            // which are extracted into directly.
+            if constexpr (isByteContainer<T>) {
+                T data;
+                readInto(data, verification);
                 return data;
             }
 
@@ -404,18 +751,72 @@ namespace KZip
             else {
                 // ===== Create a temporary vector of unsinged char, to hold the zip data
                 std::vector<unsigned char> data;
-                data.resize(m_info.m_uncomp_size);
-                mz_zip_reader_extract_to_mem(m_archive, m_info.m_file_index, data.data(), m_info.m_uncomp_size, 0);
-
-                // ===== Check that the operation was successful
-                if (!m_info.m_is_directory && data.size() != m_info.m_uncomp_size) {
-                    throw ZipRuntimeError(mz_zip_get_error_string(m_archive->m_last_error));
-                }
-
+                readInto(data, verification);
                 return { data.begin(), data.end() };
             }
         }
 
+        /**
+         * @brief Extract the entry data into a buffer provided by the caller, without allocating any memory.
+         * @details When reading from an archive file, compressed data is read through a buffer kept per thread, which is
+         * reused for all reads on that thread.
+         * @param buffer The buffer to extract into.
+         * @param size The size of the buffer; it must be at least the uncompressed size of the entry.
+         * @param verification The checksum verification policy for the read (see ZipVerification).
+         * @return The number of bytes extracted, i.e. the uncompressed size of the entry.
+         * @throw ZipLogicError if the buffer is too small.
+         * @throw ZipRuntimeError if the data can't be extracted, or if the checksum is verified and doesn't match.
+         */
+        std::size_t readInto(void* buffer, std::size_t size, ZipVerification verification = ZipVerification::Default) const;
+
+        /**
+         * @brief Extract the entry data into a container provided by the caller.
+         * @details The container is resized to the uncompressed size of the entry, and the data is extracted directly
+         * into it. If the capacity of the container is sufficient, no memory is allocated, so reusing the same container
+         * for reading many entries avoids allocations altogether.
+         * @tparam T A contiguous container of bytes, such as std::string or std::vector<unsigned char>.
+         * @param container The container to extract into.
+         * @param verification The checksum verification policy for the read (see ZipVerification).
+         */
+        template<typename T, typename std::enable_if<isByteContainer<T>>::type* = nullptr>
+        void readInto(T& container, ZipVerification verification = ZipVerification::Default) const
+        {
+            container.resize(static_cast<std::size_t>(size()));
+            readInto(container.data(), container.size(), verification);
+        }
+
+        /**
+         * @brief Read a range of the (uncompressed) entry data.
+         * @details Stored entries are read directly at the given offset. For deflated entries, checkpoints of the
+         * decompressor state are recorded as the entry is read (see ZipArchive::setSeekInterval), and each read resumes
+         * decompression from the last checkpoint before the range. Once the part of the entry before the range has been
+         * read, a read therefore costs at most one interval of decompression, in addition to the range itself.
+         * @param offset The position of the range in the uncompressed data.
+         * @param buffer The buffer to read into.
+         * @param size The size of the range.
+         * @return The number of bytes read. Fewer bytes are only read if the range extends beyond the end of the entry.
+         * @throw ZipRuntimeError if the data can't be read or decompressed.
+         * @note As only part of the data is read, the checksum of the entry is not verified.
+         */
+        std::size_t read(uint64_t offset, void* buffer, std::size_t size) const;
+
+        /**
+         * @brief Read a range of the (uncompressed) entry data into a new container.
+         * @tparam T A contiguous container of bytes, such as std::string or std::vector<unsigned char>.
+         * @param offset The position of the range in the uncompressed data.
+         * @param length The size of the range.
+         * @return The data. It is shorter than the given length if the range extends beyond the end of the entry.
+         */
+        template<typename T = std::vector<unsigned char>, typename std::enable_if<isByteContainer<T>>::type* = nullptr>
+        T read(uint64_t offset, std::size_t length) const
+        {
+            auto entrySize = size();
+            T    data;
+            data.resize(static_cast<std::size_t>(offset < entrySize ? std::min<uint64_t>(length, entrySize - offset) : 0));
+            data.resize(read(offset, data.data(), data.size()));
+            return data;
+        }
+
         /**
          * @brief Implicit type conversion operator.
          * @details This templated type conversion operator allows extraction of the zip data to any container
@@ -441,6 +842,56 @@ namespace KZip
          */
         void clear();
 
+        /**
+         * @brief Open the entry for reading its data sequentially, without holding all of it in memory.
+         * @details Use the returned ZipEntryReader directly to read chunks into buffers of any size, or wrap it in a
+         * ZipEntryStream for use as a std::istream:
+         * @code
+         * KZip::ZipEntryStream stream(archive.entry("data.csv").openStream());
+         * for (std::string line; std::getline(stream, line);) { ... }
+         * @endcode
+         * If the checksum is verified, it is checked when the end of the data has been read.
+         * @param verification The checksum verification policy for the stream (see ZipVerification). As a stream may not be
+         * read to the end, reading it doesn't count as the first read of ZipVerification::FirstRead.
+         * @return A ZipEntryReader object positioned at the start of the entry data.
+         * @throw ZipRuntimeError if the entry can't be read (e.g. if it is encrypted, or uses an unsupported method).
+         */
+        ZipEntryReader openStream(ZipVerification verification = ZipVerification::Default) const;
+
+        /**
+         * @brief Get the data of the entry as stored in the archive file, without decompressing it, e.g. for sending
+         * deflated data as is.
+         * @details If the archive is memory mapped, the returned object refers directly to the mapping. New and modified
+         * entries are not compressed until the archive is saved, so their data is returned as stored (method 0).
+         * @return A ZipCompressedData object with the data, the compression method and the checksum and size of the
+         * uncompressed data.
+         * @throw ZipRuntimeError if the data can't be read, or if the entry is encrypted.
+         * @note The data is not verified, as that would require decompressing it.
+         */
+        ZipCompressedData rawCompressed() const;
+
+        /**
+         * @brief Get a view of the data of the entry, without copying it, if the data can be accessed directly.
+         * @details This is the case for entries stored without compression (method 0) in a memory mapped archive (see
+         * OpenMode::MemoryMapped), for which the view points directly into the mapping, and for new or modified entries,
+         * for which it points to the data held by the entry. Entries that are not in the archive file yet, and folder
+         * entries, have an empty view.
+         * @return The view, or std::nullopt if the data can only be accessed by decompressing or reading it (e.g. if the
+         * entry is deflated, or the archive isn't memory mapped). Use getData() or readInto() in that case.
+         * @throw ZipRuntimeError if the local header of the entry can't be read.
+         * @note The checksum of the data is not verified. The view is valid until the archive is closed or saved, or the
+         * entry is modified.
+         */
+        std::optional<ZipByteView> view() const;
+
+        /**
+         * @brief Open the entry for reading its data as stored in the archive file sequentially, without decompressing
+         * it (see rawCompressed).
+         * @return A ZipEntryReader object positioned at the start of the stored data. Its size is the compressed size.
+         * @throw ZipRuntimeError if the entry can't be read (e.g. if it is encrypted).
+         */
+        ZipEntryReader openRawStream() const;
+
         /**
          * @brief
          * @return
@@ -475,9 +926,9 @@ namespace KZip
         /**
          * @brief
          * @param archive
-         * @param info
+         * @param slot The slot of the entry in the entry table of the archive.
          */
-        ZipEntryProxy(KZip::Impl::ZipArchive* archive, mz_zip_archive_file_stat info);
+        ZipEntryProxy(KZip::Impl::ZipArchive* archive, std::size_t slot);
 
         /**
          * @brief
@@ -499,10 +950,15 @@ namespace KZip
         ZipEntryProxy& operator=(ZipEntryProxy&& other) noexcept;
 
         /**
-         *
-         * @return
+         * @brief Get the entry record, loading the metadata from the archive file if required.
+         * @return A reference to the entry record.
+         */
+        const Impl::ZipEntryRecord& record() const;
+
+        /**
+         * @brief Remove the data and the seek index of the entry from the caches of the archive.
          */
-        const mz_zip_archive_file_stat& stats() const;
+        void uncache();
 
         /**
          *
@@ -526,38 +982,561 @@ namespace KZip
         //---------- Private Member Variables ---------- //
         KZip::Impl::ZipArchive*  m_ziparchive = nullptr;
         mz_zip_archive*          m_archive = nullptr;
-        mz_zip_archive_file_stat m_info    = mz_zip_archive_file_stat(); /**< File stats for the entry. */
+        std::size_t              m_slot { 0 }; /**< The slot of the entry in the entry table of the archive. */
         std::optional<std::vector<unsigned char> > m_data = {};
     }; // class ZipEntryProxy
 
+    /**
+     * @brief The ZipEntryView class is a lightweight handle for an entry in an archive, as yielded when iterating through
+     * the range returned by ZipArchive::entries().
+     * @details A ZipEntryView object holds only a reference to the archive and the position of the entry in it, so it is
+     * cheap to create and copy. The name and metadata are read directly from the entry table of the archive.
+     * @note A ZipEntryView object is invalidated when entries are added to, deleted from or renamed in the archive.
+     */
+    class ZipEntryView
+    {
+        friend class ZipEntryIterator;
+
+    public:
+        /**
+         * @brief Get the name of the entry.
+         * @return A std::string_view with the name. It remains valid until the archive is modified.
+         */
+        std::string_view name() const;
+
+        /**
+         * @brief Get the metadata of the entry.
+         * @return A ZipEntryMetaData object.
+         */
+        ZipEntryMetaData metadata() const;
+
+        /**
+         * @brief Get the ZipEntryProxy object for the entry, which can be used for reading and writing the entry data.
+         * @return A reference to the ZipEntryProxy object. Unlike the ZipEntryView object itself, it remains valid until
+         * the entry is deleted or the archive is closed.
+         */
+        ZipEntryProxy& entry() const;
+
+    private:
+        ZipEntryView() = default;
+
+        Impl::ZipArchive* m_archive { nullptr }; /**< The archive holding the entry. */
+        std::size_t       m_slot { 0 };          /**< The slot of the entry in the entry table of the archive. */
+    };
+
+    /**
+     * @brief The ZipEntryIterator class is a forward iterator over the entries of an archive matching a set of ZipFlags.
+     * @details The iterator steps through the entry table (or the sorted name index, if the range was created with a path),
+     * skipping entries that don't match. No memory is allocated while iterating.
+     */
+    class ZipEntryIterator
+    {
+        friend class Impl::ZipArchive;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = ZipEntryView;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const ZipEntryView*;
+        using reference         = const ZipEntryView&;
+
+        ZipEntryIterator() = default;
+
+        reference         operator*() const;
+        pointer           operator->() const;
+        ZipEntryIterator& operator++();
+        ZipEntryIterator  operator++(int);    // NOLINT
+        bool              operator==(const ZipEntryIterator& other) const;
+        bool              operator!=(const ZipEntryIterator& other) const;
+
+    private:
+        /**
+         * @brief Constructor.
+         * @param archive The archive to iterate through.
+         * @param slots A pointer to a list of slots to visit, or nullptr to visit the slots of the entry table in order.
+         * @param position The start position in the list of slots (or the entry table).
+         * @param last The end position in the list of slots (or the entry table).
+         * @param flags A ZipFlags enum indicating whether files and/or directories should be visited.
+         * @param glob A compiled glob pattern the entry names must match, or nullptr to visit all entries. If given, the
+         * slots must be sorted by name, so that non-matching subtrees can be skipped.
+         */
+        ZipEntryIterator(Impl::ZipArchive*                     archive,
+                         const std::size_t*                    slots,
+                         std::size_t                           position,
+                         std::size_t                           last,
+                         ZipFlags                              flags,
+                         std::shared_ptr<const Impl::ZipGlob> glob = nullptr);
+
+        /**
+         * @brief Advance the position to the next matching entry (or the end), starting at the current position.
+         */
+        void skipUnmatched();
+
+        ZipEntryView       m_view     = {};                /**< The view of the current entry. */
+        const std::size_t* m_slots    = nullptr;           /**< The list of slots to visit, or nullptr for the entry table. */
+        std::size_t        m_position { 0 };               /**< The current position. */
+        std::size_t        m_last { 0 };                   /**< The end position. */
+        ZipFlags           m_flags { ZipFlags::Files };    /**< The kinds of entries to visit. */
+        std::shared_ptr<const Impl::ZipGlob> m_glob = {}; /**< The pattern the entry names must match (if any). */
+    };
+
+    /**
+     * @brief The ZipEntryRange class is the range of entries returned by ZipArchive::entries(). It can be used in a
+     * range-based for loop, or with the algorithms in the standard library.
+     * @note The range is invalidated when entries are added to, deleted from or renamed in the archive.
+     */
+    class ZipEntryRange
+    {
+        friend class Impl::ZipArchive;
+
+    public:
+        ZipEntryIterator begin() const;
+        ZipEntryIterator end() const;
+
+    private:
+        ZipEntryRange(ZipEntryIterator first, ZipEntryIterator last);
+
+        ZipEntryIterator m_first = {};
+        ZipEntryIterator m_last  = {};
+    };
+
     namespace Impl
     {
         /**
-         * @brief
+         * @brief Decompress a raw deflate stream (without a zlib header) into a buffer, using the given implementation.
+         * @details The result is the same as for tinfl_decompress_mem_to_mem() with no flags, i.e. the decompression fails
+         * if the stream is invalid, or if the output doesn't fit in the buffer.
+         * @param engine The implementation.
+         * @param source The compressed data.
+         * @param sourceSize The size of the compressed data.
+         * @param destination The buffer receiving the uncompressed data.
+         * @param destinationSize The size of the buffer.
+         * @return The number of bytes decompressed, or TINFL_DECOMPRESS_MEM_TO_MEM_FAILED on failure.
          */
-        class ZipEntryWrapper {
+        std::size_t inflateBuffer(ZipInflateEngine engine, const unsigned char* source, std::size_t sourceSize, unsigned char* destination, std::size_t destinationSize);
+
+        /**
+         * @brief The ZipFileMapping class maps a file read-only into memory (see OpenMode::MemoryMapped).
+         * @details The mapping is released when the object is destroyed, or when unmap() is called. Objects can be
+         * moved, but not copied, as the mapping is owned by the object.
+         */
+        class ZipFileMapping
+        {
         public:
+            ZipFileMapping() = default;
+            ZipFileMapping(const ZipFileMapping& other) = delete;
+            ZipFileMapping(ZipFileMapping&& other) noexcept;
+            ZipFileMapping& operator=(const ZipFileMapping& other) = delete;
+            ZipFileMapping& operator=(ZipFileMapping&& other) noexcept;
+            ~ZipFileMapping();
 
             /**
-             * @brief
-             * @param entry
+             * @brief Map a file into memory. Any existing mapping is released first.
+             * @param fileName The path of the file.
+             * @return true if the file was mapped; false if memory mapping is unavailable, or the file can't be mapped
+             * (e.g. if it is empty).
              */
-            explicit ZipEntryWrapper(const ZipEntryProxy& entry);
+            bool map(const fs::path& fileName);
 
             /**
-             * @brief
-             * @return
+             * @brief Release the mapping, if any.
              */
-            const ZipEntryProxy& entry() const;
+            void unmap();
 
             /**
-             * @brief
-             * @return
+             * @brief Get a pointer to the mapped file contents.
+             * @return The pointer, or nullptr if no file is mapped.
+             */
+            const std::byte* data() const { return m_data; }
+
+            /**
+             * @brief Get the size of the mapped file.
+             * @return The size in bytes, or zero if no file is mapped.
+             */
+            std::size_t size() const { return m_size; }
+
+            /**
+             * @brief Check if a file is mapped.
+             * @return true if a file is mapped; otherwise false.
+             */
+            bool isMapped() const { return m_data != nullptr; }
+
+        private:
+            const std::byte* m_data = nullptr; /**< The start of the mapping. */
+            std::size_t      m_size { 0 };     /**< The size of the mapping. */
+#ifdef _WIN32
+            void* m_mappingHandle = nullptr; /**< The handle of the file mapping object. */
+#endif
+        };
+
+        /**
+         * @brief The ZipEntryCache class holds the decompressed data of recently read entries, up to a given number of
+         * bytes. When the cache is full, the least recently used entries are evicted.
+         * @details Entries are keyed by their index in the archive file, which is stable until the archive is saved.
+         */
+        class ZipEntryCache
+        {
+        public:
+            /**
+             * @brief Set the maximum number of bytes to hold. If zero (the default), nothing is cached.
+             * @param capacity The capacity in bytes.
+             */
+            void setCapacity(std::size_t capacity);
+
+            /**
+             * @brief Look up the data of an entry, marking it as the most recently used, and update the hit/miss counters.
+             * @param fileIndex The index of the entry in the archive file.
+             * @return A pointer to the data, or nullptr if the entry isn't cached. The pointer is invalidated when the
+             * cache is modified.
+             */
+            const std::vector<unsigned char>* find(uint32_t fileIndex);
+
+            /**
+             * @brief Add the data of an entry, evicting the least recently used entries as required. Data larger than the
+             * capacity is not added.
+             * @param fileIndex The index of the entry in the archive file.
+             * @param data The data.
+             */
+            void insert(uint32_t fileIndex, std::vector<unsigned char> data);
+
+            /**
+             * @brief Remove the data of an entry, if it is cached.
+             * @param fileIndex The index of the entry in the archive file.
+             */
+            void erase(uint32_t fileIndex);
+
+            /**
+             * @brief Remove all cached data. The capacity and the counters are retained.
+             */
+            void clear();
+
+            /**
+             * @brief Reset the hit and miss counters.
+             */
+            void resetStatistics();
+
+            /**
+             * @brief Check if the cache is enabled, i.e. if the capacity is non-zero.
+             * @return true if the cache is enabled; otherwise false.
+             */
+            bool isEnabled() const { return m_capacity > 0; }
+
+            /**
+             * @brief Get the usage statistics of the cache.
+             * @return A ZipCacheStatistics object.
+             */
+            ZipCacheStatistics statistics() const;
+
+        private:
+            using Item = std::pair<uint32_t, std::vector<unsigned char>>;
+
+            void evict(std::size_t capacity);
+
+            std::list<Item>                                         m_items  = {}; /**< The cached entries, most recently used first. */
+            std::unordered_map<uint32_t, std::list<Item>::iterator> m_lookup = {}; /**< The cached entries, by file index. */
+            std::size_t                                             m_size { 0 };     /**< The number of bytes held. */
+            std::size_t                                             m_capacity { 0 }; /**< The maximum number of bytes held. */
+            uint64_t                                                m_hits { 0 };     /**< The number of cache hits. */
+            uint64_t                                                m_misses { 0 };   /**< The number of cache misses. */
+        };
+
+        /**
+         * @brief The ZipSeekIndex class holds the checkpoints used for random access reads in a deflated entry (see
+         * ZipEntryProxy::read).
+         * @details A checkpoint is a copy of the complete decompressor state, including the 32 KB window of preceding
+         * output, taken at some position in the entry. Decompression can be resumed from a checkpoint as if the entry had
+         * been decompressed from the start up to that position. Checkpoints are recorded in order, about one interval
+         * apart, as the entry is read.
+         */
+        class ZipSeekIndex
+        {
+        public:
+            static constexpr uint64_t DefaultInterval = 1024 * 1024; /**< The default interval between checkpoints. */
+
+            /**
+             * @brief The Checkpoint struct holds the decompressor state at a position in the entry.
+             */
+            struct Checkpoint
+            {
+                uint64_t                   inputOffset { 0 };  /**< The number of compressed bytes consumed. */
+                uint64_t                   outputOffset { 0 }; /**< The number of uncompressed bytes produced. */
+                tinfl_decompressor         decompressor {};    /**< The decompressor state. */
+                std::vector<unsigned char> window = {};        /**< The output window (TINFL_LZ_DICT_SIZE bytes). */
+            };
+
+            /**
+             * @brief Constructor.
+             * @param dataOffset The offset of the compressed data of the entry in the archive file.
+             * @param interval The number of uncompressed bytes between checkpoints.
+             */
+            ZipSeekIndex(uint64_t dataOffset, uint64_t interval) : m_dataOffset(dataOffset), m_interval(interval) {}
+
+            /**
+             * @brief Get the offset of the compressed data of the entry in the archive file.
+             * @return The offset in bytes.
+             */
+            uint64_t dataOffset() const { return m_dataOffset; }
+
+            /**
+             * @brief Find the last checkpoint at or before the given position.
+             * @param offset The position in the uncompressed data.
+             * @return The checkpoint, or nullptr if decompression has to start at the beginning of the entry.
+             */
+            std::shared_ptr<const Checkpoint> find(uint64_t offset) const;
+
+            /**
+             * @brief Get the position from which the next checkpoint should be recorded.
+             * @return The position in the uncompressed data.
+             */
+            uint64_t nextOffset() const { return (m_checkpoints.empty() ? 0 : m_checkpoints.back()->outputOffset) + m_interval; }
+
+            /**
+             * @brief Add a checkpoint. It is ignored if it is less than one interval after the last checkpoint (e.g. if
+             * it has been recorded by another reader in the meantime).
+             * @param checkpoint The checkpoint.
+             */
+            void add(std::shared_ptr<const Checkpoint> checkpoint);
+
+        private:
+            uint64_t                                       m_dataOffset { 0 }; /**< The offset of the compressed data. */
+            uint64_t                                       m_interval { 0 };   /**< The interval between checkpoints. */
+            std::vector<std::shared_ptr<const Checkpoint>> m_checkpoints = {}; /**< The checkpoints, by position. */
+        };
+
+        /**
+         * @brief The ZipEntryIndex class is a hash index mapping entry names to slots in the entry table of an archive.
+         * @details The index is an open-addressing hash table with linear probing. Each bucket holds only the hash of the
+         * name and the slot number; the names themselves are owned by the entry table and are retrieved through the
+         * accessor passed to find() and erase(). This means that lookups can be done using a std::string_view, without
+         * allocating a std::string for the key, and without any per-entry heap allocations in the index itself.
+         */
+        class ZipEntryIndex
+        {
+        public:
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1); /**< Value returned if a name is not found. */
+
+            /**
+             * @brief Look up the slot of the entry with the given name.
+             * @tparam NameAccessor A callable returning the name (as a std::string_view) of the entry in a given slot.
+             * @param name The name of the entry to look up.
+             * @param nameOf The name accessor.
+             * @return The slot of the entry, or npos if no entry with the given name is registered.
+             */
+            template<typename NameAccessor>
+            std::size_t find(std::string_view name, const NameAccessor& nameOf) const
+            {
+                auto bucket = findBucket(name, nameOf);
+                return bucket == npos ? npos : m_buckets[bucket].slot;
+            }
+
+            /**
+             * @brief Register an entry name in the index.
+             * @param name The name of the entry.
+             * @param slot The slot of the entry in the entry table.
+             * @note The caller must ensure that the name is not already registered.
+             */
+            void insert(std::string_view name, std::size_t slot);
+
+            /**
+             * @brief Remove an entry name from the index.
+             * @tparam NameAccessor A callable returning the name (as a std::string_view) of the entry in a given slot.
+             * @param name The name of the entry to remove.
+             * @param nameOf The name accessor.
+             * @return true if the name was registered; otherwise false.
+             */
+            template<typename NameAccessor>
+            bool erase(std::string_view name, const NameAccessor& nameOf)
+            {
+                auto bucket = findBucket(name, nameOf);
+                if (bucket == npos) return false;
+                eraseBucket(bucket);
+                return true;
+            }
+
+            /**
+             * @brief Update the slot of a registered name, or register it if it doesn't exist.
+             * @tparam NameAccessor A callable returning the name (as a std::string_view) of the entry in a given slot.
+             * @param name The name of the entry.
+             * @param slot The new slot of the entry.
+             * @param nameOf The name accessor.
+             * @return The previous slot of the entry, or npos if the name wasn't registered.
              */
-            ZipEntryProxy& entry();
+            template<typename NameAccessor>
+            std::size_t assign(std::string_view name, std::size_t slot, const NameAccessor& nameOf)
+            {
+                return assign(name, hashOf(name), slot, nameOf);
+            }
+
+            /**
+             * @brief Update the slot of a registered name, or register it if it doesn't exist, using a precomputed hash.
+             * @details This allows the hashes of a large number of names to be computed up front (e.g. in parallel).
+             * @tparam NameAccessor A callable returning the name (as a std::string_view) of the entry in a given slot.
+             * @param name The name of the entry.
+             * @param hash The hash of the name, as returned by hashOf().
+             * @param slot The new slot of the entry.
+             * @param nameOf The name accessor.
+             * @return The previous slot of the entry, or npos if the name wasn't registered.
+             */
+            template<typename NameAccessor>
+            std::size_t assign(std::string_view name, std::size_t hash, std::size_t slot, const NameAccessor& nameOf)
+            {
+                auto bucket = findBucket(name, hash, nameOf);
+                if (bucket == npos) {
+                    insertHash(hash, slot);
+                    return npos;
+                }
+
+                return std::exchange(m_buckets[bucket].slot, slot);
+            }
+
+            /**
+             * @brief Prepare the index for holding the given number of names without rehashing.
+             * @param count The number of names.
+             */
+            void reserve(std::size_t count);
+
+            /**
+             * @brief Remove all names from the index.
+             */
+            void clear();
+
+            /**
+             * @brief Get the number of names in the index.
+             * @return The number of names.
+             */
+            std::size_t size() const;
+
+            /**
+             * @brief Write the index to a binary stream.
+             * @param stream The output stream.
+             */
+            void write(std::ostream& stream) const;
+
+            /**
+             * @brief Read an index, written by the write() function, from a binary stream.
+             * @details As the hash values are stored in the stream, the index can only be read if the hash function used
+             * when writing it is the same. This is verified, and if it isn't, the index will not be read. The buckets are
+             * checked as well, so that a damaged index can't cause lookups to read out of bounds or loop forever.
+             * @param stream The input stream.
+             * @param slotCount The number of slots in the entry table; all slots in the index must be below this.
+             * @param available The number of bytes left in the stream; larger indexes are rejected before allocating.
+             * @return true if the index was read successfully; otherwise false.
+             */
+            bool read(std::istream& stream, std::size_t slotCount, uint64_t available);
+
+            /**
+             * @brief Compute the hash of an entry name.
+             * @param name The entry name.
+             * @return The hash value.
+             */
+            static std::size_t hashOf(std::string_view name) { return std::hash<std::string_view> {}(name); }
+
+        private:
+            struct Bucket
+            {
+                std::size_t hash = 0;
+                std::size_t slot = npos;
+            };
+
+            template<typename NameAccessor>
+            std::size_t findBucket(std::string_view name, const NameAccessor& nameOf) const
+            {
+                return findBucket(name, hashOf(name), nameOf);
+            }
+
+            template<typename NameAccessor>
+            std::size_t findBucket(std::string_view name, std::size_t hash, const NameAccessor& nameOf) const
+            {
+                if (m_buckets.empty()) return npos;
+
+                auto mask = m_buckets.size() - 1;
+                for (auto pos = hash & mask;; pos = (pos + 1) & mask) {
+                    const auto& bucket = m_buckets[pos];
+                    if (bucket.slot == npos) return npos;
+                    if (bucket.hash == hash && nameOf(bucket.slot) == name) return pos;
+                }
+            }
+
+            void insertHash(std::size_t hash, std::size_t slot);
+
+            void eraseBucket(std::size_t pos);
+
+            void rehash(std::size_t bucketCount);
+
+            std::vector<Bucket> m_buckets = {}; /**< The buckets; the size is always zero or a power of two. */
+            std::size_t         m_size { 0 };   /**< The number of occupied buckets. */
+        };
+
+        /**
+         * @brief The ZipGlob class is a compiled glob pattern for matching entry names.
+         * @details The pattern is split into path segments at each '/'. Within a segment, '*' matches any sequence of
+         * characters, '?' matches any single character, '[...]' matches one of a set of characters (e.g. '[a-z]', or
+         * '[!0-9]' for the complement), and '\' escapes the following character. None of these match a '/'. A segment
+         * consisting of '**' matches any number of segments, including none.
+         *
+         * When matching a name fails in a directory segment before the first '**', no other name in that directory can
+         * match either. In that case, the length of the directory prefix is returned, so that the caller can skip the
+         * whole subtree.
+         */
+        class ZipGlob
+        {
+        public:
+            /**
+             * @brief The result of matching a name.
+             */
+            struct Result
+            {
+                bool        isMatch { false };  /**< true if the name matches the pattern. */
+                std::size_t pruneLength { 0 };  /**< If non-zero, no names starting with the first pruneLength characters of the name can match. */
+            };
+
+            /**
+             * @brief Constructor. Compiles the given pattern.
+             * @param pattern The glob pattern.
+             */
+            explicit ZipGlob(std::string_view pattern);
+
+            /**
+             * @brief Get the literal prefix of the pattern, i.e. the characters before the first wildcard. All matching
+             * names start with this prefix.
+             * @return A reference to the literal prefix.
+             */
+            const std::string& literalPrefix() const;
+
+            /**
+             * @brief Match an entry name against the pattern.
+             * @param name The entry name.
+             * @return A Result object.
+             */
+            Result match(std::string_view name) const;
 
         private:
-            ZipEntryProxy m_entry;
+            struct Segment
+            {
+                std::string pattern;              /**< The pattern for the segment. */
+                bool        isLiteral { false };  /**< true if the pattern contains no wildcards. */
+                bool        isGlobstar { false }; /**< true if the pattern is '**'. */
+            };
+
+            bool matchFrom(std::size_t segment, std::string_view name, std::size_t position) const;
+
+            static bool        matchSegment(const Segment& segment, std::string_view text);
+            static std::size_t matchCharacter(std::string_view pattern, std::size_t position, char character);
+
+            std::vector<Segment> m_segments      = {}; /**< The segments of the pattern. */
+            std::size_t          m_fixedCount { 0 };   /**< The number of segments before the first '**'. */
+            std::string          m_literalPrefix = {}; /**< The characters before the first wildcard. */
+        };
+
+        /**
+         * @brief The ZipExtractions struct counts the extractions of an archive running in the background (see
+         * ZipArchive::extractAsync), so that closing or saving the archive can wait for them.
+         */
+        struct ZipExtractions
+        {
+            std::mutex              mutex;          /**< The lock for the count. */
+            std::condition_variable finished;       /**< Signalled when an extraction finishes. */
+            std::size_t             count { 0 };    /**< The number of extractions running. */
         };
 
         /**
@@ -567,6 +1546,8 @@ namespace KZip
         {
             friend class KZip::ZipArchive;
             friend class KZip::ZipEntryProxy;
+            friend class KZip::ZipEntryView;
+            friend class KZip::ZipEntryIterator;
 
         public:
             /**
@@ -617,10 +1598,13 @@ namespace KZip
              * @brief Open an existing archive file with the given filename.
              * @details The archive file is opened and meta data for all the entries in the archive is loaded into memory.
              * @param fileName The filename/path of the archive to open.
+             * @param mode The OpenMode to use. In lazy mode, only the entry names are indexed when the archive is opened.
+             * @param threadCount The number of threads used for decoding the central directory and building the name
+             * indexes. If zero, the number of hardware threads is used.
              * @note If more than one entry with the same name exists in the archive, only the newest one will be loaded.
              * When saving the archive, only the loaded entries will be kept; other entries with the same name will be deleted.
              */
-            void open(const fs::path& fileName);
+            void open(const fs::path& fileName, OpenMode mode = OpenMode::Default, std::size_t threadCount = 1);
 
             /**
              * @brief Add an entry to the archive.
@@ -631,6 +1615,12 @@ namespace KZip
              */
             ZipEntryProxy& addEntry(const std::string& path);
 
+            /**
+             * @brief Prepare the entry table and the name index for adding the given number of entries.
+             * @param count The number of entries to be added.
+             */
+            void reserveEntries(std::size_t count);
+
             /**
              * @brief
              * @param name
@@ -661,10 +1651,13 @@ namespace KZip
             std::vector<std::string> entryNames(ZipFlags flags) const;
 
             /**
-             * @brief
-             * @param path
-             * @param flags
-             * @return
+             * @brief Get a list of the entries in the archive with names starting with the given path.
+             * @details The entries are found using a sorted name index, so the cost is proportional to the number of
+             * matching entries, rather than the size of the archive.
+             * @param path The path (or name prefix) of the entries to list. If empty, all entries are listed.
+             * @param flags A ZipFlags enum indicating whether files and/or directories should be included.
+             * @return A std::vector of std::strings with the entry names. If a path is given, the names are sorted
+             * lexicographically; otherwise they are in archive order.
              */
             std::vector<std::string> entryNames(const std::string& path, ZipFlags flags) const;
 
@@ -673,15 +1666,33 @@ namespace KZip
              * @param flags
              * @return
              */
-            uint16_t entryCount(ZipFlags flags = (ZipFlags::Files)) const;
+            uint64_t entryCount(ZipFlags flags = (ZipFlags::Files)) const;
 
             /**
-             * @brief
-             * @param path
-             * @param flags
-             * @return
+             * @brief Get a range of the entries in the archive with names starting with the given path.
+             * @param path The path (or name prefix) of the entries. If empty, all entries are included, in archive order.
+             * Otherwise, the entries are sorted by name.
+             * @param flags A ZipFlags enum indicating whether files and/or directories should be included.
+             * @return A ZipEntryRange object.
+             */
+            ZipEntryRange entries(std::string_view path, ZipFlags flags) const;
+
+            /**
+             * @brief Get a range of the entries in the archive with names matching the given glob pattern.
+             * @param pattern The glob pattern (see ZipGlob).
+             * @param flags A ZipFlags enum indicating whether files and/or directories should be included.
+             * @return A ZipEntryRange object, with the matching entries sorted by name.
+             */
+            ZipEntryRange find(std::string_view pattern, ZipFlags flags) const;
+
+            /**
+             * @brief Count the entries in the archive with names starting with the given path.
+             * @details The entries are counted directly in the sorted name index, without building a list of names.
+             * @param path The path (or name prefix) of the entries to count. If empty, all entries are counted.
+             * @param flags A ZipFlags enum indicating whether files and/or directories should be counted.
+             * @return The number of matching entries.
              */
-            uint16_t entryCount(const std::string& path, ZipFlags flags = (ZipFlags::Files)) const;
+            uint64_t entryCount(const std::string& path, ZipFlags flags = (ZipFlags::Files)) const;
 
             /**
              * @brief
@@ -690,6 +1701,61 @@ namespace KZip
              */
             bool hasEntry(const std::string& entryName) const;
 
+            /**
+             * @brief Get the number of entries that were dropped when the archive was opened, because they were shadowed by
+             * newer entries with the same name.
+             * @return The number of shadowed entries.
+             */
+            uint64_t shadowedEntryCount() const;
+
+            /**
+             * @brief Set the maximum number of bytes of decompressed entry data to cache. If zero, nothing is cached.
+             * @param capacity The capacity in bytes.
+             */
+            void setCacheSize(std::size_t capacity);
+
+            /**
+             * @brief Get the usage statistics of the cache of decompressed entry data.
+             * @return A ZipCacheStatistics object.
+             */
+            ZipCacheStatistics cacheStatistics() const;
+
+            /**
+             * @brief Remove all data from the cache, and reset the hit and miss counters. The seek indexes of the entries
+             * are removed as well.
+             */
+            void clearCache();
+
+            /**
+             * @brief Set the interval between the checkpoints recorded for random access reads in deflated entries.
+             * @param interval The number of uncompressed bytes between checkpoints. It applies to entries read after the call.
+             */
+            void setSeekInterval(uint64_t interval);
+
+            /**
+             * @brief Set the checksum verification policy for reads of entries that don't select one.
+             * @param verification The policy. ZipVerification::Default selects ZipVerification::Always.
+             */
+            void setVerification(ZipVerification verification);
+
+            /**
+             * @brief Get the checksum verification policy for reads of entries that don't select one.
+             * @return The policy.
+             */
+            ZipVerification verification() const;
+
+            /**
+             * @brief Set the implementation used for decompressing entries in one go.
+             * @param engine The implementation.
+             */
+            void setInflateEngine(ZipInflateEngine engine);
+
+            /**
+             * @brief Get the implementation used for decompressing entries in one go.
+             * @return The implementation.
+             */
+            ZipInflateEngine inflateEngine() const;
+
             /**
              * @brief Close the archive for reading and writing.
              * @note If the archive has been modified but not saved, all changes will be discarded.
@@ -710,22 +1776,316 @@ namespace KZip
              */
             void save(fs::path filename = {});
 
+            /**
+             * @brief Extract all entries to a directory, using a number of threads.
+             * @param directory The directory to extract to. It is created if it doesn't exist.
+             * @param options The extraction options.
+             */
+            void extractAll(const fs::path& directory, const ZipExtractOptions& options) const;
+
+            /**
+             * @brief Extract the given entries, in the order they are stored in the archive file, reading adjacent entries
+             * with a single read.
+             * @param names The names of the entries.
+             * @param sink The callback receiving the data of each entry.
+             */
+            void extract(const std::vector<std::string>& names, const ZipEntrySink& sink) const;
+
+            /**
+             * @brief Extract the given entries in the background, reading many entries at once and decompressing them on
+             * a number of worker threads.
+             * @param names The names of the entries.
+             * @param sink The callback receiving the data of each entry. It is called from the worker threads.
+             * @param threadCount The number of worker threads, or 0 to use one per CPU core.
+             * @return A std::future that is ready when all entries have been extracted.
+             */
+            std::future<void> extractAsync(const std::vector<std::string>& names, ZipEntrySink sink, std::size_t threadCount = 0) const;
+
         private:
             /**
-             * @brief Create a new mz_zip_archive_file_stat structure.
-             * @details This function will create a new mz_zip_archive_file_stat structure, based on the input file name. The
-             * structure values will mostly be dummy values, except for the file index, the time stamp, the file name
-             * and the is_directory flag.
-             * @param name The file name for the new ZipEntryInfo.
-             * @return The newly created ZipEntryInfo structure is returned
+             * @brief Create a new entry record.
+             * @details This function will create a new entry record for a new entry with the given name. The record values
+             * will mostly be dummy values, except for the file index, the time stamp and the isDirectory flag. The name is
+             * not stored in the name arena (see storeName).
+             * @param name The name of the new entry.
+             * @return The newly created ZipEntryRecord is returned.
+             */
+            ZipEntryRecord createRecord(std::string_view name);
+
+            /**
+             * @brief Store a name in the name arena, and set the name offset and length of the given record accordingly.
+             * @details The name is stored with a terminating null character, so that it can be passed to miniz directly.
+             * @param record The record for the entry.
+             * @param name The name of the entry.
+             */
+            void storeName(ZipEntryRecord& record, std::string_view name);
+
+            /**
+             * @brief Get the entry record in the given slot, loading the metadata from the archive file if it hasn't been
+             * loaded yet (see OpenMode::Lazy).
+             * @param slot The slot of the entry.
+             * @return A reference to the entry record.
+             */
+            const ZipEntryRecord& record(std::size_t slot) const;
+
+            /**
+             * @brief Get the ZipEntryProxy object for the entry in the given slot, creating it if it doesn't exist yet.
+             * @param slot The slot of the entry.
+             * @return A reference to the ZipEntryProxy object.
+             */
+            ZipEntryProxy& proxy(std::size_t slot) const;
+
+            /**
+             * @brief Create a mz_zip_archive_file_stat structure for the entry in the given slot.
+             * @param slot The slot of the entry.
+             * @return The mz_zip_archive_file_stat structure.
+             */
+            mz_zip_archive_file_stat fileStat(std::size_t slot) const;
+
+            /**
+             * @brief Get the ZipEntryProxy object for the entry in the given slot, if the entry has been modified.
+             * @param slot The slot of the entry.
+             * @return A pointer to the ZipEntryProxy object holding the new data, or nullptr if the entry is read from the
+             * archive file.
+             */
+            const ZipEntryProxy* updatedProxy(std::size_t slot) const;
+
+            /**
+             * @brief Decompress an entry from a buffer holding its local header and compressed data, and verify the checksum.
+             * @param slot The slot of the entry.
+             * @param header A pointer to the local header of the entry.
+             * @param available The number of bytes available from the local header.
+             * @param data The vector receiving the uncompressed data.
+             * @return true if the entry was decompressed; false if the buffer doesn't hold all of the compressed data
+             * (e.g. because the local header has a larger extra field than allowed for).
+             * @throw ZipRuntimeError if the data can't be decompressed, or if the checksum doesn't match.
+             */
+            bool inflateEntry(std::size_t slot, const unsigned char* header, uint64_t available, std::vector<unsigned char>& data) const;
+
+            /**
+             * @brief Decompress an entry in the archive file into a buffer with the inflate engine of the archive (see
+             * setInflateEngine), instead of through miniz.
+             * @details Memory mapped archives are decompressed in place; otherwise, the compressed data is read into a
+             * buffer kept per thread.
+             * @param slot The slot of the entry in the entry table.
+             * @param buffer The buffer receiving the uncompressed data. It must hold the uncompressed size of the entry.
+             * @param isVerify true if the checksum should be verified.
+             * @return true if the entry was decompressed; false if it should be read through miniz, i.e. if the engine is
+             * ZipInflateEngine::Miniz, or if the entry isn't deflated, is encrypted, or has too much compressed data to read
+             * at once.
+             * @throw ZipRuntimeError if the data can't be decompressed, or if the checksum doesn't match.
+             */
+            bool inflateInto(std::size_t slot, void* buffer, bool isVerify) const;
+
+            /**
+             * @brief Decode the data of an entry, verifying the checksum if required.
+             * @param slot The slot of the entry in the entry table.
+             * @param source The compressed data.
+             * @param destination The buffer receiving the uncompressed data. It must hold the uncompressed size of the entry.
+             * @param isVerify true if the checksum should be verified.
+             * @throw ZipRuntimeError if the entry is encrypted or uses an unsupported method, if the data can't be
+             * decompressed, or if the checksum doesn't match.
+             */
+            void decodeEntry(std::size_t slot, const unsigned char* source, unsigned char* destination, bool isVerify) const;
+
+            /**
+             * @brief Check if the checksum should be verified when reading an entry in the archive file.
+             * @param slot The slot of the entry in the entry table.
+             * @param verification The policy selected for the read; ZipVerification::Default selects the archive policy.
+             * @return true if the checksum should be verified.
+             */
+            bool isVerifying(std::size_t slot, ZipVerification verification) const;
+
+            /**
+             * @brief Record that the checksum of an entry has been verified (see ZipVerification::FirstRead).
+             * @param slot The slot of the entry in the entry table.
              */
-            mz_zip_archive_file_stat createInfo(const std::string& name);
+            void setVerified(std::size_t slot) const;
 
-            mz_zip_archive    m_archive      = mz_zip_archive(); /**< The struct used by miniz, to handle archive files. */
-            std::vector<ZipEntryWrapper> m_zipEntryData = {};
-            fs::path          m_archivePath  = {}; /**< The path of the archive file. */
-            bool              m_isOpen { false };  /**< A flag indicating if the file is currently open for reading and writing. */
-            uint32_t          m_currentIndex { 0 };
+            /**
+             * @brief Extract a list of entries, sorted by position, using a ReadQueue and a number of worker threads (see
+             * extractAsync).
+             * @param requests The local header offsets and slots of the entries.
+             * @param sink The callback receiving the data of each entry.
+             * @param threadCount The number of worker threads, or 0 to use one per CPU core.
+             */
+            void extractQueued(const std::vector<std::pair<uint64_t, std::size_t>>& requests, const ZipEntrySink& sink, std::size_t threadCount) const;
+
+            /**
+             * @brief Read a range of the data of an entry in the archive file (see ZipEntryProxy::read).
+             * @param slot The slot of the entry.
+             * @param offset The position of the range in the uncompressed data.
+             * @param buffer The buffer to read into.
+             * @param size The size of the range.
+             * @return The number of bytes read.
+             */
+            std::size_t readRange(std::size_t slot, uint64_t offset, void* buffer, std::size_t size) const;
+
+            /**
+             * @brief Find the position of the compressed data of an entry in the archive file, from its local header.
+             * @param slot The slot of the entry.
+             * @return The position of the first byte of compressed data.
+             * @throw ZipRuntimeError if the local header can't be read, or doesn't match the central directory.
+             */
+            uint64_t dataOffset(std::size_t slot) const;
+
+            /**
+             * @brief Get the compressed data of an entry in the archive file (see ZipEntryProxy::rawCompressed).
+             * @param slot The slot of the entry.
+             * @return The ZipCompressedData object.
+             */
+            ZipCompressedData compressedData(std::size_t slot) const;
+
+            /**
+             * @brief Get the name of an entry directly from the central directory of the archive file.
+             * @param fileIndex The index of the entry in the archive file.
+             * @return A std::string_view with the entry name, pointing into the central directory held by miniz.
+             */
+            std::string_view centralDirName(uint32_t fileIndex) const;
+
+            /**
+             * @brief Get the name of the entry in the given slot of the entry table.
+             * @param slot The slot of the entry.
+             * @return A std::string_view with the entry name, pointing into the name arena.
+             */
+            std::string_view entryName(std::size_t slot) const;
+
+            /**
+             * @brief Look up the slot in the entry table of the entry with the given name.
+             * @param name The name of the entry.
+             * @return The slot of the entry, or ZipEntryIndex::npos if it doesn't exist.
+             */
+            std::size_t findEntry(std::string_view name) const;
+
+            /**
+             * @brief Append a new entry to the entry table and register it in the name index.
+             * @details If the table is full and at least half of the slots are occupied by deleted entries, the table will
+             * be compacted instead of being reallocated.
+             * @param record The record for the new entry.
+             * @param name The name of the new entry.
+             * @return The slot of the new entry.
+             * @note The caller must ensure that no entry with the same name exists.
+             */
+            std::size_t appendEntry(ZipEntryRecord record, std::string_view name);
+
+            /**
+             * @brief Ensure that all parent folders of an entry are registered in the entry table.
+             * @details The parent folders are checked from the bottom up, stopping at the first registered folder, as the
+             * folders above it will already be registered. In the common case, where the immediate parent folder exists,
+             * the cost is a single lookup in the name index.
+             * @param name The name of the entry.
+             */
+            void registerParentFolders(std::string_view name);
+
+            /**
+             * @brief Change the name of an existing entry, updating the name index accordingly.
+             * @details If another entry with the new name exists, it will be deleted.
+             * @param slot The slot of the entry.
+             * @param newName The new name of the entry.
+             */
+            void renameEntry(std::size_t slot, const std::string& newName);
+
+            /**
+             * @brief Remove deleted entries from the entry table and rebuild the name index.
+             * @note This will invalidate any references to deleted entries in the archive.
+             */
+            void compact();
+
+            /**
+             * @brief Check if the entry in the given slot is a live entry of the kind(s) given by the flags.
+             * @param slot The slot of the entry.
+             * @param flags A ZipFlags enum indicating whether files and/or directories should be matched.
+             * @return true if the entry matches; otherwise false.
+             */
+            bool matchesFlags(std::size_t slot, ZipFlags flags) const;
+
+            /**
+             * @brief Rebuild the sorted name index from scratch, from the live entries in the entry table.
+             */
+            void rebuildSortedIndex() const;
+
+            /**
+             * @brief Get the range of slots in the sorted name index, for the entries with names starting with the given prefix.
+             * @details Entries added since the last query are merged into the sorted index first. The range is found by
+             * binary search, so the cost of a query is logarithmic in the size of the archive and linear in the number of
+             * matching entries.
+             * @param prefix The prefix to search for. An empty prefix matches all entries.
+             * @return A pair of iterators into the sorted index. The range may include deleted entries.
+             */
+            std::pair<std::vector<std::size_t>::const_iterator, std::vector<std::size_t>::const_iterator>
+                prefixRange(std::string_view prefix) const;
+
+            /**
+             * @brief Skip the entries with names starting with the given prefix, in a list of slots sorted by name.
+             * @param slots The list of slots.
+             * @param first The position of the first entry with the prefix.
+             * @param last The end position.
+             * @param prefix The prefix.
+             * @return The position of the first entry without the prefix (or last).
+             */
+            std::size_t skipPrefix(const std::size_t* slots, std::size_t first, std::size_t last, std::string_view prefix) const;
+
+            /**
+             * @brief Get the path of the sidecar index file for the archive (see OpenMode::Indexed).
+             * @return The path of the index file.
+             */
+            fs::path indexFilePath() const;
+
+            /**
+             * @brief Load the entry table, the name index and the sorted name index from the sidecar index file.
+             * @details The index file is only used if it was written for an archive file of the same size and modification
+             * time as the one currently open, by a build of this library using the same record layout and hash function.
+             * @return true if the index file was loaded; otherwise false, in which case the tables are left empty.
+             */
+            bool readIndexFile();
+
+            /**
+             * @brief Write the entry table, the name index and the sorted name index to the sidecar index file.
+             * @note The index file is a cache; if it can't be written, it is silently skipped.
+             */
+            void writeIndexFile() const;
+
+            /**
+             * @brief Lock the bookkeeping of the archive (lazily loaded records, proxies, the sorted name index and the
+             * cache) against concurrent access.
+             * @return A lock holding the mutex if the archive was opened with OpenMode::Concurrent; otherwise an empty lock.
+             */
+            std::unique_lock<std::mutex> lock() const;
+
+            /**
+             * @brief Drop the cached data and the seek index of an entry in the archive file, when its data is replaced
+             * or the entry is deleted.
+             * @param slot The slot of the entry.
+             */
+            void uncache(std::size_t slot);
+
+            /**
+             * @brief Wait until all extractions running in the background have finished (see extractAsync).
+             */
+            void waitForExtractions() const;
+
+            mz_zip_archive                   m_archive      = mz_zip_archive(); /**< The struct used by miniz, to handle archive files. */
+            ZipFileMapping                   m_mapping      = {};               /**< The archive file mapping, if opened in memory mapped mode. */
+            ZipEntryCache                    m_cache        = {};               /**< The cache of decompressed entry data. */
+            mutable std::unordered_map<uint32_t, ZipSeekIndex> m_seekIndexes = {}; /**< The seek indexes of entries read by range, by file index. */
+            uint64_t                         m_seekInterval { ZipSeekIndex::DefaultInterval }; /**< The interval between checkpoints in new seek indexes. */
+            ZipVerification                  m_verification { ZipVerification::Always }; /**< The checksum verification policy of the archive. */
+            ZipInflateEngine                 m_inflateEngine { ZipInflateEngine::Fast }; /**< The implementation used for decompressing entries in one go. */
+            std::unique_ptr<std::mutex>      m_mutex        = {};               /**< The lock for the bookkeeping, if opened in concurrent mode. */
+            std::unique_ptr<ZipExtractions>  m_extractions  = std::make_unique<ZipExtractions>(); /**< The extractions running in the background. */
+            std::vector<ZipEntryRecord>      m_entries      = {};               /**< The entry table, including deleted entries. */
+            std::string                      m_nameArena    = {};               /**< The names of all entries in the entry table. */
+            mutable std::vector<std::unique_ptr<ZipEntryProxy>> m_proxies = {}; /**< ZipEntryProxy objects for the entries, created on demand. */
+            ZipEntryIndex                    m_entryIndex   = {};               /**< Name index for the live entries in the entry table. */
+            mutable std::vector<std::size_t> m_sortedSlots  = {};               /**< Slots of the entries, sorted by name. */
+            mutable std::vector<std::size_t> m_pendingSlots = {};               /**< Slots of new entries not yet merged into m_sortedSlots. */
+            std::size_t                      m_deletedCount { 0 };              /**< The number of deleted entries in the entry table. */
+            uint64_t                         m_shadowedCount { 0 };             /**< The number of entries shadowed by newer entries with the same name. */
+            fs::path                         m_archivePath  = {};               /**< The path of the archive file. */
+            bool                             m_isOpen { false };                /**< A flag indicating if the file is currently open for reading and writing. */
+            OpenMode                         m_openMode { OpenMode::Default };  /**< The mode used to open the archive. */
+            std::size_t                      m_threadCount { 1 };               /**< The number of threads used for building the tables. */
+            uint32_t                         m_currentIndex { 0 };
         };
     }    // namespace Impl
 
@@ -792,8 +2152,9 @@ namespace KZip
          * The constructors tries to open an std::ifstream. If it is valid, it means that a file already exists
          * and will be opened. Otherwise, the file does not exist and will be created.
          * @param fileName The name of the file to open or create.
+         * @param mode The OpenMode to use when opening the archive.
          */
-        explicit ZipArchive(const fs::path& fileName);
+        explicit ZipArchive(const fs::path& fileName, OpenMode mode = OpenMode::Default);
 
         /**
          * @brief Copy Constructor (deleted).
@@ -848,11 +2209,31 @@ namespace KZip
          * @details
          * ##### Implementation details
          * The archive file is opened and meta data for all the entries in the archive is loaded into memory.
+         * If the archive is opened with OpenMode::Lazy, only the entry names are read from the central directory when
+         * the archive is opened, and the meta data for an entry is loaded when the entry is first accessed. This makes
+         * opening a large archive to read a few entries considerably faster.
+         *
+         * If the archive is opened with OpenMode::MemoryMapped, the archive file is mapped into memory, and entries are
+         * read from the mapping, without any system calls. The file remains mapped until the archive is closed.
+         *
+         * For archives with a large number of entries, the central directory can be decoded and the name indexes built
+         * using multiple threads. Small archives are always opened on the calling thread.
+         *
+         * ##### Thread safety
+         * By default, an archive object must only be used by one thread at a time. If the archive is opened with
+         * OpenMode::Concurrent, any number of threads may read entries at the same time, i.e. call the const member
+         * functions of the archive (such as entry(), hasEntry(), entries() and extractAll()) and the reading member
+         * functions of the entries (such as metadata(), getData(), readInto() and openStream()). Each read uses
+         * positional I/O (or the memory mapping), so reads don't share a file position, and no lock is held while
+         * data is read or decompressed. Functions that modify the archive or its entries (such as addEntry(), deleteEntry(),
+         * setData(), setName(), save() and close()) must not be called while other threads use the archive.
          * @param fileName The filename of the archive to open.
+         * @param mode The OpenMode to use.
+         * @param threadCount The number of threads to use. If zero, the number of hardware threads is used.
          * @note If more than one entry with the same name exists in the archive, only the newest one will be loaded.
          * When saving the archive, only the loaded entries will be kept; other entries with the same name will be deleted.
          */
-        void open(const fs::path& fileName);
+        void open(const fs::path& fileName, OpenMode mode = OpenMode::Default, std::size_t threadCount = 1);
 
         /**
          * @brief Close the archive for reading and writing.
@@ -876,10 +2257,11 @@ namespace KZip
         std::vector<std::string> entryNames(ZipFlags flags = (ZipFlags::Files)) const;
 
         /**
-         * @brief
-         * @param path
-         * @param flags
-         * @return
+         * @brief Get a list of the entries in the archive with names starting with the given path (e.g. a folder name).
+         * @details The cost is proportional to the number of matching entries, not the size of the archive.
+         * @param path The path (or name prefix) of the entries to list. If empty, all entries are listed.
+         * @param flags A ZipFlags enum indicating whether files and/or directories should be included.
+         * @return A std::vector of std::strings with the entry names, sorted lexicographically if a path is given.
          */
         std::vector<std::string> entryNames(const std::string& path, ZipFlags flags = (ZipFlags::Files)) const;
 
@@ -888,18 +2270,53 @@ namespace KZip
          * @param flags
          * @return
          */
-        uint16_t entryCount(ZipFlags flags = (ZipFlags::Files));
+        uint64_t entryCount(ZipFlags flags = (ZipFlags::Files));
 //        {
 //            return m_archive->entryCount(flags);
 //        }
 
         /**
-         * @brief
-         * @param path
-         * @param flags
-         * @return
+         * @brief Count the entries in the archive with names starting with the given path (e.g. a folder name).
+         * @details The cost is proportional to the number of matching entries, not the size of the archive.
+         * @param path The path (or name prefix) of the entries to count. If empty, all entries are counted.
+         * @param flags A ZipFlags enum indicating whether files and/or directories should be counted.
+         * @return The number of matching entries.
          */
-        uint16_t entryCount(const std::string& path, ZipFlags flags = (ZipFlags::Files));
+        uint64_t entryCount(const std::string& path, ZipFlags flags = (ZipFlags::Files));
+
+        /**
+         * @brief Get a range of the entries in the archive, for iterating through the entries without copying the names.
+         * @details The range yields ZipEntryView objects, in archive order. No memory is allocated while iterating.
+         * @param flags A ZipFlags enum indicating whether files and/or directories should be included.
+         * @return A ZipEntryRange object.
+         * @note The range is invalidated when entries are added to, deleted from or renamed in the archive.
+         */
+        ZipEntryRange entries(ZipFlags flags = (ZipFlags::Files));
+
+        /**
+         * @brief Get a range of the entries in the archive with names starting with the given path (e.g. a folder name).
+         * @details The range yields ZipEntryView objects, sorted by name. The cost is proportional to the number of
+         * matching entries, not the size of the archive.
+         * @param path The path (or name prefix) of the entries. If empty, all entries are included, in archive order.
+         * @param flags A ZipFlags enum indicating whether files and/or directories should be included.
+         * @return A ZipEntryRange object.
+         * @note The range is invalidated when entries are added to, deleted from or renamed in the archive.
+         */
+        ZipEntryRange entries(std::string_view path, ZipFlags flags = (ZipFlags::Files));
+
+        /**
+         * @brief Find the entries in the archive with names matching a glob pattern, e.g. "xl/worksheets/sheet?.xml" or "media/" followed by "**".
+         * @details '*' and '?' match any sequence of characters and any single character, respectively, and '[...]'
+         * matches one of a set of characters; none of these match a '/'. A path segment consisting of '**' matches any
+         * number of folders. The pattern is compiled once, and only the part of the archive that can hold matching
+         * entries is searched: the literal prefix of the pattern is looked up in the sorted name index, and folders that
+         * cannot hold matching entries are skipped.
+         * @param pattern The glob pattern.
+         * @param flags A ZipFlags enum indicating whether files and/or directories should be included.
+         * @return A ZipEntryRange object. The entries are matched lazily, as the range is iterated, in order of name.
+         * @note The range is invalidated when entries are added to, deleted from or renamed in the archive.
+         */
+        ZipEntryRange find(std::string_view pattern, ZipFlags flags = (ZipFlags::Files));
 
         /**
          * @brief Check if an entry with a given name exists in the archive.
@@ -908,6 +2325,77 @@ namespace KZip
          */
         bool hasEntry(const std::string& entryName) const;
 
+        /**
+         * @brief Get the number of entries that were dropped when the archive was opened, because they were shadowed by
+         * newer entries with the same name.
+         * @details Archives that have been appended to may hold several entries with the same name. Only the newest of
+         * these (i.e. the last one in the central directory) is visible, and only that one is written when the archive is saved.
+         * @return The number of shadowed entries.
+         */
+        uint64_t shadowedEntryCount() const;
+
+        /**
+         * @brief Enable caching of decompressed entry data, up to the given number of bytes.
+         * @details When an entry in the archive file is read, its decompressed data is kept in the cache, so that reading
+         * it again doesn't require decompressing it. When the cache is full, the least recently used entries are evicted.
+         * The cache is disabled by default. Cached data is discarded when the data of an entry is changed, and when the
+         * archive is saved or closed.
+         * @param capacity The capacity of the cache in bytes. If zero, the cache is disabled.
+         */
+        void setCacheSize(std::size_t capacity);
+
+        /**
+         * @brief Get the usage statistics of the cache of decompressed entry data, e.g. for choosing the cache size.
+         * @return A ZipCacheStatistics object.
+         */
+        ZipCacheStatistics cacheStatistics() const;
+
+        /**
+         * @brief Remove all data from the cache, and reset the hit and miss counters. The seek indexes built for random
+         * access reads (see ZipEntryProxy::read) are removed as well.
+         */
+        void clearCache();
+
+        /**
+         * @brief Set the interval between the checkpoints recorded for random access reads in deflated entries (see
+         * ZipEntryProxy::read).
+         * @details A read decompresses at most one interval of data before the requested range, but each checkpoint
+         * takes about 43 KB of memory. The default is one checkpoint per MB (ZipSeekIndex::DefaultInterval).
+         * @param interval The number of uncompressed bytes between checkpoints. It applies to entries read after the call.
+         */
+        void setSeekInterval(uint64_t interval);
+
+        /**
+         * @brief Set when the checksums of entries are verified as they are read, for reads that don't select a policy
+         * themselves (e.g. ZipEntryProxy::getData(), and all reads by extract(), extractAsync() and extractAll()).
+         * @details The default, ZipVerification::Always, verifies every read, which is appropriate for untrusted archives.
+         * For archives that are read repeatedly, ZipVerification::FirstRead verifies each entry once, and skips the
+         * checksum on later reads. ZipVerification::Never skips it altogether, e.g. for archives just written by the caller.
+         * @param verification The policy. ZipVerification::Default restores ZipVerification::Always.
+         */
+        void setVerification(ZipVerification verification);
+
+        /**
+         * @brief Get the checksum verification policy of the archive (see setVerification).
+         * @return The policy.
+         */
+        ZipVerification verification() const;
+
+        /**
+         * @brief Select the implementation used for decompressing deflated entries in one go, i.e. by getData(),
+         * readInto(), extract() and extractAsync().
+         * @details The default, ZipInflateEngine::Fast, is about twice as fast as miniz on text, and gains less on
+         * data with short matches. Both produce the same output, so miniz is mainly useful as a reference.
+         * @param engine The implementation.
+         */
+        void setInflateEngine(ZipInflateEngine engine);
+
+        /**
+         * @brief Get the implementation used for decompressing deflated entries in one go (see setInflateEngine).
+         * @return The implementation.
+         */
+        ZipInflateEngine inflateEngine() const;
+
         /**
          * @brief Save the archive with a new name. The original archive will remain unchanged.
          * @param filename The new filename.
@@ -916,6 +2404,52 @@ namespace KZip
          */
         void save(const fs::path& filename = {});
 
+        /**
+         * @brief Extract all entries in the archive to a directory, decompressing the entries on a number of threads.
+         * @details The folders are created first; the files are then extracted by a pool of worker threads, each reading
+         * the archive through its own reader (or from the memory mapping, if the archive is memory mapped). The files are
+         * extracted in order of decreasing size, so that large files don't end up delaying the completion at the end.
+         * New and modified entries are written with the data held in memory.
+         * @param directory The directory to extract to. It is created if it doesn't exist.
+         * @param options The extraction options, e.g. the number of threads.
+         * @throws ZipRuntimeError if an entry can't be extracted, or if the name of an entry would place it outside the
+         * target directory (e.g. if it contains '..'). In the latter case, nothing is extracted.
+         */
+        void extractAll(const fs::path& directory, const ZipExtractOptions& options = {}) const;
+
+        /**
+         * @brief Extract a list of entries, passing the data of each entry to a callback.
+         * @details The entries are extracted in the order they are stored in the archive file, rather than in the order
+         * of the list, so the archive file is read sequentially. Entries stored close together are read with a single
+         * read of up to a few MB, and then decompressed from memory. This turns many small, scattered reads into a few
+         * large, sequential ones, which matters most on spinning disks and network file systems.
+         * @param names The names of the entries to extract. Unknown names are reported before anything is extracted.
+         * @param sink The callback receiving the name and the data of each entry. The data is only valid during the call.
+         * @throws ZipLogicError if an entry doesn't exist.
+         * @throws ZipRuntimeError if an entry can't be read or decompressed, or if the checksum doesn't match.
+         */
+        void extract(const std::vector<std::string>& names, const ZipEntrySink& sink) const;
+
+        /**
+         * @brief Extract a list of entries in the background, passing the data of each entry to a callback.
+         * @details The local headers and compressed data of many entries are read at once, in the order they are stored
+         * in the archive file, and each entry is decompressed by one of a number of worker threads as soon as its read
+         * completes. On Linux, if the library is built with the ENABLE_IO_URING option and the kernel supports it, the
+         * reads are submitted to the kernel in batches using io_uring, so that many reads are in flight at once;
+         * otherwise, positional reads (pread) are used. Memory mapped archives are decompressed in place.
+         * @note The callback is called from the worker threads, concurrently and in no particular order, so it must be
+         * thread safe. The archive must not be modified until the returned future is ready; close(), save() and the
+         * destructor wait for the extraction to finish, so they must not be called from the callback. Like any future
+         * returned by std::async, its destructor waits for the extraction to finish as well.
+         * @param names The names of the entries to extract. Unknown names are reported before anything is extracted.
+         * @param sink The callback receiving the name and the data of each entry. The data is only valid during the call.
+         * @param threadCount The number of worker threads, or 0 to use one per CPU core.
+         * @return A std::future that is ready when all entries have been extracted. Errors from reading, decompressing
+         * or from the callback are rethrown by std::future::get(); the first error stops the extraction.
+         * @throws ZipLogicError if an entry doesn't exist.
+         */
+        std::future<void> extractAsync(const std::vector<std::string>& names, ZipEntrySink sink, std::size_t threadCount = 0) const;
+
         /**
          * @brief Deletes an entry from the archive.
          * @param name The name of the entry to delete.
@@ -940,6 +2474,22 @@ namespace KZip
          */
         ZipEntryProxy& addEntry(const std::string& name);
 
+        /**
+         * @brief Add a number of entries to the archive in one operation.
+         * @details The entry table is prepared for the new entries up front, and the cost of registering the parent folders
+         * of each entry is constant, so that the cost of adding the entries is linear in the number of entries.
+         * @tparam Range A range of pairs (or tuples) of entry name and data, e.g. a std::vector<std::pair<std::string, std::string>>.
+         * The data can be any container accepted by ZipEntryProxy::setData.
+         * @param entries The entries to add.
+         * @note If an entry with given name already exists, it will be overwritten.
+         */
+        template<typename Range>
+        void addEntries(const Range& entries)
+        {
+            m_archive->reserveEntries(static_cast<std::size_t>(std::distance(std::begin(entries), std::end(entries))));
+            for (const auto& [name, data] : entries) m_archive->addEntry(name).setData(data);
+        }
+
     private:
         std::unique_ptr<Impl::ZipArchive> m_archive = std::make_unique<Impl::ZipArchive>();
     };
@@ -1,4 +1,7 @@
 #define MINIZ_EXPORT inline
+
+/* KZip: mz_crc32() is defined in KZip.cpp, which selects a hardware accelerated implementation at runtime. */
+#define USE_EXTERNAL_MZCRC
 /* miniz.c 2.2.0 - public domain deflate/inflate, zlib-subset, ZIP reading/writing/appending, PNG writing
    See "unlicense" statement at the end of this file.
    Rich Geldreich <richgel99@gmail.com>, last updated Oct. 13, 2013
@@ -207,7 +210,11 @@ extern "C" {
 
 #define MZ_CRC32_INIT (0)
          /* mz_crc32() returns the initial CRC-32 value to use when called with ptr==NULL. */
+#ifdef USE_EXTERNAL_MZCRC
+         mz_ulong mz_crc32(mz_ulong crc, const unsigned char *ptr, size_t buf_len);
+#else
          MINIZ_EXPORT mz_ulong mz_crc32(mz_ulong crc, const unsigned char *ptr, size_t buf_len);
+#endif
 
          /* Compression strategies. */
          enum
@@ -1012,7 +1019,8 @@ extern "C" {
              MZ_ZIP_FLAG_ASCII_FILENAME = 0x10000,
              /*After adding a compressed file, seek back
              to local file header and set the correct sizes*/
-             MZ_ZIP_FLAG_WRITE_HEADER_SET_SIZE = 0x20000
+             MZ_ZIP_FLAG_WRITE_HEADER_SET_SIZE = 0x20000,
+             MZ_ZIP_FLAG_SKIP_CRC32_CHECK = 0x40000 /* KZip: don't compute or verify the crc32 of extracted data (reader extract functions) */
          } mz_zip_flags;
 
          typedef enum {
@@ -5735,7 +5743,7 @@ mz_bool mz_zip_reader_locate_file_v2(mz_zip_archive *pZip, const char *pName, co
     return mz_zip_set_error(pZip, MZ_ZIP_FILE_NOT_FOUND);
 }
 
-mz_bool mz_zip_reader_extract_to_mem_no_alloc(mz_zip_archive *pZip, mz_uint file_index, void *pBuf, size_t buf_size, mz_uint flags, void *pUser_read_buf, size_t user_read_buf_size)
+static mz_bool mz_zip_reader_extract_to_mem_no_alloc1(mz_zip_archive *pZip, mz_uint file_index, void *pBuf, size_t buf_size, mz_uint flags, void *pUser_read_buf, size_t user_read_buf_size, const mz_zip_archive_file_stat *st)
 {
     int status = TINFL_STATUS_DONE;
     mz_uint64 needed_size, cur_file_ofs, comp_remaining, out_buf_ofs = 0, read_buf_size, read_buf_ofs = 0, read_buf_avail;
@@ -5748,7 +5756,9 @@ mz_bool mz_zip_reader_extract_to_mem_no_alloc(mz_zip_archive *pZip, mz_uint file
     if ((!pZip) || (!pZip->m_pState) || ((buf_size) && (!pBuf)) || ((user_read_buf_size) && (!pUser_read_buf)) || (!pZip->m_pRead))
         return mz_zip_set_error(pZip, MZ_ZIP_INVALID_PARAMETER);
 
-    if (!mz_zip_reader_file_stat(pZip, file_index, &file_stat))
+    if (st)
+        file_stat = *st;
+    else if (!mz_zip_reader_file_stat(pZip, file_index, &file_stat))
         return MZ_FALSE;
 
     /* A directory or zero length file */
@@ -5787,7 +5797,7 @@ mz_bool mz_zip_reader_extract_to_mem_no_alloc(mz_zip_archive *pZip, mz_uint file
             return mz_zip_set_error(pZip, MZ_ZIP_FILE_READ_FAILED);
 
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
-        if ((flags & MZ_ZIP_FLAG_COMPRESSED_DATA) == 0)
+        if ((flags & (MZ_ZIP_FLAG_COMPRESSED_DATA | MZ_ZIP_FLAG_SKIP_CRC32_CHECK)) == 0)
         {
             if (mz_crc32(MZ_CRC32_INIT, (const mz_uint8 *)pBuf, (size_t)file_stat.m_uncomp_size) != file_stat.m_crc32)
                 return mz_zip_set_error(pZip, MZ_ZIP_CRC_CHECK_FAILED);
@@ -5864,7 +5874,7 @@ mz_bool mz_zip_reader_extract_to_mem_no_alloc(mz_zip_archive *pZip, mz_uint file
             status = TINFL_STATUS_FAILED;
         }
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
-        else if (mz_crc32(MZ_CRC32_INIT, (const mz_uint8 *)pBuf, (size_t)file_stat.m_uncomp_size) != file_stat.m_crc32)
+        else if (!(flags & MZ_ZIP_FLAG_SKIP_CRC32_CHECK) && mz_crc32(MZ_CRC32_INIT, (const mz_uint8 *)pBuf, (size_t)file_stat.m_uncomp_size) != file_stat.m_crc32)
         {
             mz_zip_set_error(pZip, MZ_ZIP_CRC_CHECK_FAILED);
             status = TINFL_STATUS_FAILED;
@@ -5878,6 +5888,11 @@ mz_bool mz_zip_reader_extract_to_mem_no_alloc(mz_zip_archive *pZip, mz_uint file
     return status == TINFL_STATUS_DONE;
 }
 
+mz_bool mz_zip_reader_extract_to_mem_no_alloc(mz_zip_archive *pZip, mz_uint file_index, void *pBuf, size_t buf_size, mz_uint flags, void *pUser_read_buf, size_t user_read_buf_size)
+{
+    return mz_zip_reader_extract_to_mem_no_alloc1(pZip, file_index, pBuf, buf_size, flags, pUser_read_buf, user_read_buf_size, NULL);
+}
+
 mz_bool mz_zip_reader_extract_file_to_mem_no_alloc(mz_zip_archive *pZip, const char *pFilename, void *pBuf, size_t buf_size, mz_uint flags, void *pUser_read_buf, size_t user_read_buf_size)
 {
     mz_uint32 file_index;
@@ -6023,7 +6038,7 @@ mz_bool mz_zip_reader_extract_to_callback(mz_zip_archive *pZip, mz_uint file_ind
                 mz_zip_set_error(pZip, MZ_ZIP_WRITE_CALLBACK_FAILED);
                 status = TINFL_STATUS_FAILED;
             }
-            else if (!(flags & MZ_ZIP_FLAG_COMPRESSED_DATA))
+            else if (!(flags & (MZ_ZIP_FLAG_COMPRESSED_DATA | MZ_ZIP_FLAG_SKIP_CRC32_CHECK)))
             {
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
                 file_crc32 = (mz_uint32)mz_crc32(file_crc32, (const mz_uint8 *)pRead_buf, (size_t)file_stat.m_comp_size);
@@ -6047,7 +6062,7 @@ mz_bool mz_zip_reader_extract_to_callback(mz_zip_archive *pZip, mz_uint file_ind
                 }
 
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
-                if (!(flags & MZ_ZIP_FLAG_COMPRESSED_DATA))
+                if (!(flags & (MZ_ZIP_FLAG_COMPRESSED_DATA | MZ_ZIP_FLAG_SKIP_CRC32_CHECK)))
                 {
                     file_crc32 = (mz_uint32)mz_crc32(file_crc32, (const mz_uint8 *)pRead_buf, (size_t)read_buf_avail);
                 }
@@ -6111,7 +6126,8 @@ mz_bool mz_zip_reader_extract_to_callback(mz_zip_archive *pZip, mz_uint file_ind
                     }
 
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
-                    file_crc32 = (mz_uint32)mz_crc32(file_crc32, pWrite_buf_cur, out_buf_size);
+                    if (!(flags & MZ_ZIP_FLAG_SKIP_CRC32_CHECK))
+                        file_crc32 = (mz_uint32)mz_crc32(file_crc32, pWrite_buf_cur, out_buf_size);
 #endif
                     if ((out_buf_ofs += out_buf_size) > file_stat.m_uncomp_size)
                     {
@@ -6133,7 +6149,7 @@ mz_bool mz_zip_reader_extract_to_callback(mz_zip_archive *pZip, mz_uint file_ind
             status = TINFL_STATUS_FAILED;
         }
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
-        else if (file_crc32 != file_stat.m_crc32)
+        else if (!(flags & MZ_ZIP_FLAG_SKIP_CRC32_CHECK) && file_crc32 != file_stat.m_crc32)
         {
             mz_zip_set_error(pZip, MZ_ZIP_DECOMPRESSION_FAILED);
             status = TINFL_STATUS_FAILED;
@@ -6159,7 +6175,7 @@ mz_bool mz_zip_reader_extract_file_to_callback(mz_zip_archive *pZip, const char
     return mz_zip_reader_extract_to_callback(pZip, file_index, pCallback, pOpaque, flags);
 }
 
-mz_zip_reader_extract_iter_state* mz_zip_reader_extract_iter_new(mz_zip_archive *pZip, mz_uint file_index, mz_uint flags)
+static mz_zip_reader_extract_iter_state* mz_zip_reader_extract_iter_new1(mz_zip_archive *pZip, mz_uint file_index, mz_uint flags, const mz_zip_archive_file_stat *st)
 {
     mz_zip_reader_extract_iter_state *pState;
     mz_uint32 local_header_u32[(MZ_ZIP_LOCAL_DIR_HEADER_SIZE + sizeof(mz_uint32) - 1) / sizeof(mz_uint32)];
@@ -6178,7 +6194,9 @@ mz_zip_reader_extract_iter_state* mz_zip_reader_extract_iter_new(mz_zip_archive
     }
 
     /* Fetch file details */
-    if (!mz_zip_reader_file_stat(pZip, file_index, &pState->file_stat))
+    if (st)
+        pState->file_stat = *st;
+    else if (!mz_zip_reader_file_stat(pZip, file_index, &pState->file_stat))
     {
         pZip->m_pFree(pZip->m_pAlloc_opaque, pState);
         return NULL;
@@ -6287,6 +6305,11 @@ mz_zip_reader_extract_iter_state* mz_zip_reader_extract_iter_new(mz_zip_archive
     return pState;
 }
 
+mz_zip_reader_extract_iter_state* mz_zip_reader_extract_iter_new(mz_zip_archive *pZip, mz_uint file_index, mz_uint flags)
+{
+    return mz_zip_reader_extract_iter_new1(pZip, file_index, flags, NULL);
+}
+
 mz_zip_reader_extract_iter_state* mz_zip_reader_extract_file_iter_new(mz_zip_archive *pZip, const char *pFilename, mz_uint flags)
 {
     mz_uint32 file_index;
@@ -6333,7 +6356,7 @@ size_t mz_zip_reader_extract_iter_read(mz_zip_reader_extract_iter_state* pState,
 
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
         /* Compute CRC if not returning compressed data only */
-        if (!(pState->flags & MZ_ZIP_FLAG_COMPRESSED_DATA))
+        if (!(pState->flags & (MZ_ZIP_FLAG_COMPRESSED_DATA | MZ_ZIP_FLAG_SKIP_CRC32_CHECK)))
             pState->file_crc32 = (mz_uint32)mz_crc32(pState->file_crc32, (const mz_uint8 *)pvBuf, copied_to_caller);
 #endif
 
@@ -6392,7 +6415,8 @@ size_t mz_zip_reader_extract_iter_read(mz_zip_reader_extract_iter_state* pState,
 
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
                 /* Perform CRC */
-                pState->file_crc32 = (mz_uint32)mz_crc32(pState->file_crc32, pWrite_buf_cur, to_copy);
+                if (!(pState->flags & MZ_ZIP_FLAG_SKIP_CRC32_CHECK))
+                    pState->file_crc32 = (mz_uint32)mz_crc32(pState->file_crc32, pWrite_buf_cur, to_copy);
 #endif
 
                 /* Decrement data consumed from block */
@@ -6434,7 +6458,7 @@ mz_bool mz_zip_reader_extract_iter_free(mz_zip_reader_extract_iter_state* pState
             pState->status = TINFL_STATUS_FAILED;
         }
 #ifndef MINIZ_DISABLE_ZIP_READER_CRC32_CHECKS
-        else if (pState->file_crc32 != pState->file_stat.m_crc32)
+        else if (!(pState->flags & MZ_ZIP_FLAG_SKIP_CRC32_CHECK) && pState->file_crc32 != pState->file_stat.m_crc32)
         {
             mz_zip_set_error(pState->pZip, MZ_ZIP_DECOMPRESSION_FAILED);
             pState->status = TINFL_STATUS_FAILED;
@@ -0,0 +1,51 @@
+//
+// Benchmark for adding a large number of entries to a new archive, one at a time and in bulk.
+//
+// Usage: AddEntriesBenchmark [entry count...]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    vector<uint64_t> counts = { 25000, 50000, 100000 };
+    if (argc > 1) {
+        counts.clear();
+        for (int i = 1; i < argc; ++i) counts.push_back(strtoull(argv[i], nullptr, 10));
+    }
+
+    const string archiveName = "./AddEntriesBenchmark.zip";
+
+    for (auto count : counts) {
+        // ===== Generate the entries up front, so that only the insertion is timed.
+        vector<pair<string, string>> entries;
+        entries.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) entries.emplace_back(syntheticEntryName(i), "data for entry " + to_string(i));
+
+        KZip::ZipArchive archive;
+        archive.create(archiveName);
+        auto singleTime = timeMilliseconds([&]() {
+            for (const auto& [name, data] : entries) archive.addEntry(name) = data;
+        });
+        archive.close();
+
+        archive.create(archiveName);
+        auto bulkTime = timeMilliseconds([&]() { archive.addEntries(entries); });
+        archive.close();
+
+        cout << "Entries: " << count << endl;
+        cout << "  addEntry():      " << singleTime << " ms" << endl;
+        cout << "  addEntries():    " << bulkTime << " ms" << endl;
+
+        remove(archiveName.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+//
+// Benchmark for repeatedly reading the same set of compressed entries, with and without the cache of decompressed data.
+//
+// Usage: CacheBenchmark [entry count] [rounds]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    uint64_t count  = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200;
+    uint64_t rounds = argc > 2 ? strtoull(argv[2], nullptr, 10) : 50;
+
+    // ===== Create an archive with compressed entries resembling the manifests and shared strings of an office document.
+    const string archiveName = "./CacheBenchmark.zip";
+    {
+        KZip::ZipArchive archive;
+        archive.create(archiveName);
+        for (uint64_t i = 0; i < count; ++i) {
+            string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<sst count=\"1000\">";
+            for (int j = 0; j < 1000; ++j) xml += "<si><t>String " + to_string(i * 1000 + j) + "</t></si>";
+            archive.addEntry("xl/strings" + to_string(i) + ".xml") = xml + "</sst>";
+        }
+        archive.save();
+    }
+
+    auto timeToReadAll = [&](size_t cacheSize) {
+        KZip::ZipArchive archive;
+        archive.open(archiveName);
+        archive.setCacheSize(cacheSize);
+
+        uint64_t bytes = 0;
+        string   data;
+        auto     time = timeMilliseconds([&]() {
+            for (uint64_t round = 0; round < rounds; ++round)
+                for (const auto& item : archive.entries()) {
+                    item.entry().readInto(data);
+                    bytes += data.size();
+                }
+        });
+
+        auto statistics = archive.cacheStatistics();
+        cout << "  cache size " << cacheSize << ": " << time << " ms (" << statistics.hits << " hits, " << statistics.misses
+             << " misses, " << bytes / (1024 * 1024) << " MB read)" << endl;
+    };
+
+    cout << "Entries: " << count << ", rounds: " << rounds << endl;
+    timeToReadAll(0);
+    timeToReadAll(64 * 1024 * 1024);
+
+    remove(archiveName.c_str());
+    return 0;
+}
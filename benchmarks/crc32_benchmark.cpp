@@ -0,0 +1,46 @@
+//
+// Benchmark for the CRC-32 implementations: the byte-wise table lookup used by miniz, vs. slice-by-16 and the hardware
+// accelerated implementations supported by the CPU. The implementation used by mz_crc32() is marked.
+//
+// Usage: Crc32Benchmark [buffer size in MB]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    uint64_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 256;
+
+    vector<unsigned char> data(megabytes * 1024 * 1024);
+    mt19937_64            generator(42);
+    for (auto& byte : data) byte = static_cast<unsigned char>(generator());
+
+    using KZip::Impl::Crc32Engine;
+    const pair<Crc32Engine, const char*> engines[] = { { Crc32Engine::Bytewise, "byte-wise (miniz)" },
+                                                       { Crc32Engine::SliceBy16, "slice-by-16" },
+                                                       { Crc32Engine::Clmul, "PCLMULQDQ" },
+                                                       { Crc32Engine::ArmCrc, "ARMv8 CRC32" } };
+
+    // ===== Measure large buffers, and the 4 KB blocks typical for small entries.
+    cout << "CRC-32 of " << megabytes << " MB:" << endl;
+    for (const auto& [engine, name] : engines) {
+        if (!KZip::Impl::isSupported(engine)) continue;
+
+        uint32_t crc      = 0;
+        auto     largeMs  = timeMilliseconds([&]() { crc = KZip::Impl::updateCrc32(engine, 0, data.data(), data.size()); });
+        auto     smallMs  = timeMilliseconds([&]() {
+            for (size_t offset = 0; offset + 4096 <= data.size(); offset += 4096) crc ^= KZip::Impl::updateCrc32(engine, 0, data.data() + offset, 4096);
+        });
+        auto     selected = engine == KZip::Impl::crc32Engine() ? " (used by mz_crc32)" : "";
+        cout << "  " << name << selected << ": " << static_cast<double>(megabytes) * 1000 / largeMs << " MB/s, in 4 KB blocks "
+             << static_cast<double>(megabytes) * 1000 / smallMs << " MB/s [" << hex << crc << dec << "]" << endl;
+    }
+
+    return 0;
+}
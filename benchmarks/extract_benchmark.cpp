@@ -0,0 +1,74 @@
+//
+// Benchmark for extracting all entries of an archive with a mix of large and small, compressible and incompressible
+// entries: a serial loop over entryNames() and getData(), vs. extractAll() with 1, 4 and 16 threads.
+//
+// Usage: ExtractBenchmark [archive size in MB]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+int main(int argc, char* argv[])
+{
+    uint64_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 256;
+
+    // ===== Create the archive directly through miniz: a few large entries and many small ones, half of them text and
+    // half of them random (incompressible) data.
+    const string archiveName = "./ExtractBenchmark.zip";
+    const string targetPath  = "./ExtractBenchmark";
+    {
+        mz_zip_archive archive = mz_zip_archive();
+        mz_zip_writer_init_file(&archive, archiveName.c_str(), 0);
+
+        mt19937  generator(42);
+        uint64_t total = 0;
+        for (uint64_t i = 0; total < megabytes * 1024 * 1024; ++i) {
+            auto   size = i % 100 == 0 ? 16 * 1024 * 1024 : 64 * 1024 + generator() % (256 * 1024);
+            string data(size, '\0');
+            if (i % 2 == 0)
+                for (size_t j = 0; j < size; ++j) data[j] = static_cast<char>('a' + (j * 7 + j / 13) % 26);
+            else
+                for (auto& c : data) c = static_cast<char>(generator());
+
+            auto name = "folder" + to_string(i % 20) + "/file" + to_string(i) + (i % 2 == 0 ? ".txt" : ".bin");
+            mz_zip_writer_add_mem(&archive, name.c_str(), data.data(), data.size(), MZ_DEFAULT_COMPRESSION);
+            total += size;
+        }
+
+        mz_zip_writer_finalize_archive(&archive);
+        mz_zip_writer_end(&archive);
+    }
+
+    KZip::ZipArchive archive;
+    archive.open(archiveName);
+
+    auto serial = timeMilliseconds([&]() {
+        for (const auto& name : archive.entryNames(KZip::ZipFlags::Directories)) fs::create_directories(fs::path(targetPath) / name);
+        for (const auto& name : archive.entryNames(KZip::ZipFlags::Files)) {
+            auto     data = archive.entry(name).getData<vector<unsigned char>>();
+            ofstream stream(fs::path(targetPath) / name, ios::binary);
+            stream.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size()));
+        }
+    });
+    fs::remove_all(targetPath);
+
+    cout << "Archive: " << megabytes << " MB, " << archive.entryCount() << " entries" << endl;
+    cout << "  serial loop:                  " << serial << " ms" << endl;
+    for (size_t threads : { 1, 4, 16 }) {
+        auto time = timeMilliseconds([&]() { archive.extractAll(targetPath, { threads }); });
+        cout << "  extractAll with " << threads << " thread(s): " << (threads < 10 ? " " : "") << time << " ms" << endl;
+        fs::remove_all(targetPath);
+    }
+
+    archive.close();
+    remove(archiveName.c_str());
+    return 0;
+}
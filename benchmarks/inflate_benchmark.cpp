@@ -0,0 +1,108 @@
+//
+// Benchmark for the inflate engines: tinfl (miniz) vs. the fast engine of KZip, on text, XML and binary data compressed
+// at the default level. Throughput is reported in MB/s of uncompressed data, for the best of five runs, and the outputs
+// are compared.
+//
+// Usage: InflateBenchmark [corpus size in MB]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+namespace
+{
+    const char* const Words[] = { "the",   "of",    "and",   "archive", "entry",  "to",      "in",     "data",   "is",
+                                  "file",  "that",  "for",   "with",    "stream", "buffer",  "a",      "it",     "as",
+                                  "table", "block", "which", "compressed", "each", "symbol", "length", "distance", "be" };
+
+    const char* randomWord(mt19937_64& generator) { return Words[generator() % (sizeof Words / sizeof Words[0])]; }
+
+    // ===== Prose made of common words, with punctuation and line breaks.
+    string createText(size_t size, mt19937_64& generator)
+    {
+        string text;
+        while (text.size() < size) {
+            text += randomWord(generator);
+            auto next = generator() % 20;
+            text += next == 0 ? ".\n" : next == 1 ? ", " : " ";
+        }
+        text.resize(size);
+        return text;
+    }
+
+    // ===== Records with repeated element and attribute names, and varying values.
+    string createXml(size_t size, mt19937_64& generator)
+    {
+        string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<records>\n";
+        for (uint64_t id = 0; xml.size() < size; ++id) {
+            xml += "  <record id=\"" + to_string(id) + "\" type=\"" + randomWord(generator) + "\">\n";
+            xml += "    <value unit=\"mm\">" + to_string(generator() % 100000) + "</value>\n";
+            xml += "    <name>" + string(randomWord(generator)) + " " + randomWord(generator) + "</name>\n";
+            xml += "  </record>\n";
+        }
+        xml.resize(size);
+        return xml;
+    }
+
+    // ===== Tables of small integers and floating point values, with some random bytes, resembling binary file formats.
+    string createBinary(size_t size, mt19937_64& generator)
+    {
+        string data;
+        while (data.size() < size) {
+            uint32_t values[4] = { static_cast<uint32_t>(data.size() / 16), static_cast<uint32_t>(generator() % 256), 0, 0 };
+            auto     number    = static_cast<float>(generator() % 1000) / 8;
+            memcpy(&values[2], &number, sizeof number);
+            values[3] = generator() % 8 == 0 ? static_cast<uint32_t>(generator()) : values[1];
+            data.append(reinterpret_cast<const char*>(values), sizeof values);
+        }
+        data.resize(size);
+        return data;
+    }
+}    // namespace
+
+int main(int argc, char* argv[])
+{
+    uint64_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 64;
+    auto     size      = static_cast<size_t>(megabytes * 1024 * 1024);
+
+    mt19937_64                        generator(42);
+    const pair<const char*, string> corpora[] = { { "text", createText(size, generator) },
+                                                  { "XML", createXml(size, generator) },
+                                                  { "binary", createBinary(size, generator) } };
+
+    cout << "Inflating " << megabytes << " MB:" << endl;
+    for (const auto& [name, data] : corpora) {
+        size_t compressedSize = 0;
+        auto*  compressed     = static_cast<unsigned char*>(tdefl_compress_mem_to_heap(data.data(), data.size(), &compressedSize,
+                                                                                        tdefl_create_comp_flags_from_zip_params(MZ_DEFAULT_LEVEL, -15, MZ_DEFAULT_STRATEGY)));
+        if (!compressed) throw KZip::ZipRuntimeError("Unable to compress the corpus");
+
+        vector<unsigned char> reference(data.size());
+        vector<unsigned char> output(data.size());
+        auto                  inflateWith = [&](KZip::ZipInflateEngine engine, vector<unsigned char>& result) {
+            auto best = numeric_limits<double>::max();
+            for (int run = 0; run < 5; ++run) {
+                best = min(best, timeMilliseconds([&]() {
+                    if (KZip::Impl::inflateBuffer(engine, compressed, compressedSize, result.data(), result.size()) != result.size())
+                        throw KZip::ZipRuntimeError("Unable to inflate the corpus");
+                }));
+            }
+            return best;
+        };
+
+        auto minizMs = inflateWith(KZip::ZipInflateEngine::Miniz, reference);
+        auto fastMs  = inflateWith(KZip::ZipInflateEngine::Fast, output);
+        mz_free(compressed);
+
+        cout << "  " << name << " (ratio " << static_cast<double>(data.size()) / static_cast<double>(compressedSize) << "): tinfl "
+             << static_cast<double>(megabytes) * 1000 / minizMs << " MB/s, fast " << static_cast<double>(megabytes) * 1000 / fastMs
+             << " MB/s, speedup " << minizMs / fastMs << (output == reference ? "" : " [OUTPUT DIFFERS]") << endl;
+    }
+
+    return 0;
+}
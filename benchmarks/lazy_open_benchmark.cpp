@@ -0,0 +1,46 @@
+//
+// Benchmark for the time it takes to open a large archive and read a single entry, with and without lazy opening,
+// and with a sidecar index file.
+//
+// Usage: LazyOpenBenchmark [entry count]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    uint64_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+    const string archiveName = "./LazyOpenBenchmark.zip";
+    createSyntheticArchive(archiveName, count);
+    auto entryName = syntheticEntryName(count / 2);
+
+    auto timeToFirstRead = [&](KZip::OpenMode mode) {
+        string data;
+        auto   time = timeMilliseconds([&]() {
+            KZip::ZipArchive archive;
+            archive.open(archiveName, mode);
+            data = archive.entry(entryName).getData<string>();
+            archive.close();
+        });
+        if (data.empty()) throw KZip::ZipRuntimeError("Unable to read " + entryName);
+        return time;
+    };
+
+    cout << "Entries: " << count << endl;
+    cout << "  time to first read (default): " << timeToFirstRead(KZip::OpenMode::Default) << " ms" << endl;
+    cout << "  time to first read (lazy):    " << timeToFirstRead(KZip::OpenMode::Lazy) << " ms" << endl;
+
+    // ===== The first open with an index file writes it; the second one loads it.
+    cout << "  time to first read (indexed, writing index): " << timeToFirstRead(KZip::OpenMode::Indexed) << " ms" << endl;
+    cout << "  time to first read (indexed, reading index): " << timeToFirstRead(KZip::OpenMode::Indexed) << " ms" << endl;
+
+    remove(archiveName.c_str());
+    remove((archiveName + ".kzidx").c_str());
+    return 0;
+}
@@ -0,0 +1,84 @@
+//
+// Benchmark for looking up every entry by name in a large archive.
+//
+// Usage: LookupBenchmark [entry count...]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <regex>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    vector<uint64_t> counts = { 100000, 1000000 };
+    if (argc > 1) {
+        counts.clear();
+        for (int i = 1; i < argc; ++i) counts.push_back(strtoull(argv[i], nullptr, 10));
+    }
+
+    const string archiveName = "./LookupBenchmark.zip";
+
+    for (auto count : counts) {
+        createSyntheticArchive(archiveName, count);
+
+        KZip::ZipArchive archive;
+        auto             openTime = timeMilliseconds([&]() { archive.open(archiveName); });
+
+        // ===== Generate the names up front, so that only the lookups are timed.
+        vector<string> names;
+        names.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) names.push_back(syntheticEntryName(i));
+
+        uint64_t found      = 0;
+        auto     lookupTime = timeMilliseconds([&]() {
+            for (const auto& name : names) {
+                if (archive.hasEntry(name) && archive.entry(name).name().size() == name.size()) ++found;
+            }
+        });
+
+        // ===== Enumerate all entries, by copying the names and by iterating through the entry range.
+        uint64_t copiedBytes = 0;
+        auto     namesTime   = timeMilliseconds([&]() {
+            for (const auto& name : archive.entryNames()) copiedBytes += name.size();
+        });
+
+        uint64_t viewedBytes = 0;
+        auto     entriesTime = timeMilliseconds([&]() {
+            for (const auto& item : archive.entries()) viewedBytes += item.name().size();
+        });
+        if (copiedBytes != viewedBytes) throw KZip::ZipRuntimeError("Enumeration mismatch");
+
+        // ===== Select the entries in a few subfolders, by filtering all names with a regex and by a glob query.
+        uint64_t   regexCount = 0;
+        const auto regex      = std::regex("folder7/sub1./[^/]*\\.txt");
+        auto       regexTime  = timeMilliseconds([&]() {
+            for (const auto& name : archive.entryNames())
+                if (std::regex_match(name, regex)) ++regexCount;
+        });
+
+        uint64_t findCount = 0;
+        auto     findTime  = timeMilliseconds([&]() {
+            for (const auto& item : archive.find("folder7/sub1?/*.txt")) findCount += !item.name().empty();
+        });
+        if (regexCount != findCount) throw KZip::ZipRuntimeError("Query mismatch");
+
+        cout << "Entries: " << count << endl;
+        cout << "  open():          " << openTime << " ms" << endl;
+        cout << "  lookup all:      " << lookupTime << " ms (" << found << " found)" << endl;
+        cout << "  per lookup:      " << lookupTime * 1.0e6 / static_cast<double>(count) << " ns" << endl;
+        cout << "  entryNames():    " << namesTime << " ms" << endl;
+        cout << "  entries():       " << entriesTime << " ms" << endl;
+        cout << "  regex query:     " << regexTime << " ms (" << regexCount << " found)" << endl;
+        cout << "  find():          " << findTime << " ms (" << findCount << " found)" << endl;
+
+        archive.close();
+        remove(archiveName.c_str());
+    }
+
+    return 0;
+}
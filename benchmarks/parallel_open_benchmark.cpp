@@ -0,0 +1,42 @@
+//
+// Benchmark for the time it takes to open a large archive using a varying number of threads.
+//
+// Usage: ParallelOpenBenchmark [entry count]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    uint64_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000000;
+
+    const string archiveName = "./ParallelOpenBenchmark.zip";
+    createSyntheticArchive(archiveName, count);
+
+    auto timeToOpen = [&](KZip::OpenMode mode, size_t threads) {
+        uint64_t entries = 0;
+        auto     time    = timeMilliseconds([&]() {
+            KZip::ZipArchive archive;
+            archive.open(archiveName, mode, threads);
+            entries = archive.entryCount();
+            archive.close();
+        });
+        if (entries < count) throw KZip::ZipRuntimeError("Unable to open " + archiveName);
+        return time;
+    };
+
+    cout << "Entries: " << count << " (hardware threads: " << thread::hardware_concurrency() << ")" << endl;
+    for (size_t threads : { 1, 4, 16 }) {
+        cout << "  open with " << threads << " thread(s) (default): " << timeToOpen(KZip::OpenMode::Default, threads) << " ms" << endl;
+        cout << "  open with " << threads << " thread(s) (lazy):    " << timeToOpen(KZip::OpenMode::Lazy, threads) << " ms" << endl;
+    }
+
+    remove(archiveName.c_str());
+    return 0;
+}
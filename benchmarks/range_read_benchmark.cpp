@@ -0,0 +1,69 @@
+//
+// Benchmark for reading random ranges of a large deflated entry: decompressing from the start of the entry for each
+// range (using a stream), vs. ZipEntryProxy::read, which resumes from the nearest checkpoint.
+//
+// Usage: RangeReadBenchmark [entry size in MB]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    uint64_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 128;
+
+    const string archiveName = "./RangeReadBenchmark.zip";
+    {
+        string content;
+        content.reserve(megabytes * 1024 * 1024);
+        for (uint64_t i = 0; content.size() < megabytes * 1024 * 1024; ++i)
+            content += "<row id=\"" + to_string(i) + "\"><value>" + to_string(i * 7919 % 100003) + "</value></row>\n";
+
+        mz_zip_archive archive = mz_zip_archive();
+        mz_zip_writer_init_file(&archive, archiveName.c_str(), 0);
+        mz_zip_writer_add_mem(&archive, "data.xml", content.data(), content.size(), MZ_DEFAULT_COMPRESSION);
+        mz_zip_writer_finalize_archive(&archive);
+        mz_zip_writer_end(&archive);
+    }
+
+    KZip::ZipArchive archive;
+    archive.open(archiveName);
+    const auto& entry = archive.entry("data.xml");
+
+    constexpr size_t rangeCount  = 20;
+    constexpr size_t rangeLength = 64 * 1024;
+    mt19937_64       generator(42);
+    vector<uint64_t> offsets;
+    for (size_t i = 0; i < rangeCount; ++i) offsets.push_back(generator() % (entry.metadata().uncompressedSize() - rangeLength));
+
+    vector<char> buffer(rangeLength);
+    auto         fromStart = timeMilliseconds([&]() {
+        for (auto offset : offsets) {
+            KZip::ZipEntryStream stream(entry.openStream());
+            stream.ignore(static_cast<streamsize>(offset));
+            stream.read(buffer.data(), rangeLength);
+        }
+    });
+
+    auto indexed = [&]() {
+        return timeMilliseconds([&]() {
+            for (auto offset : offsets) entry.read(offset, buffer.data(), rangeLength);
+        });
+    };
+    auto firstPass  = indexed();
+    auto secondPass = indexed();
+
+    cout << "Entry: " << megabytes << " MB, " << rangeCount << " ranges of " << rangeLength / 1024 << " KB" << endl;
+    cout << "  decompress from start:         " << fromStart << " ms" << endl;
+    cout << "  read(), building the index:    " << firstPass << " ms" << endl;
+    cout << "  read(), with the index built:  " << secondPass << " ms" << endl;
+
+    archive.close();
+    remove(archiveName.c_str());
+    return 0;
+}
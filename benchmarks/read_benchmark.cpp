@@ -0,0 +1,53 @@
+//
+// Benchmark for the time it takes to read every entry in an archive, using file I/O and using a memory mapping, and
+// with a new container per read vs. reading into a reused container, and with and without verifying the checksums.
+//
+// Usage: ReadBenchmark [entry count]
+//
+
+#include "synthetic_archive.h"
+#include <KZip.hpp>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    uint64_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200000;
+
+    const string archiveName = "./ReadBenchmark.zip";
+    createSyntheticArchive(archiveName, count);
+
+    auto timeToReadAll = [&](KZip::OpenMode mode, bool reuseContainer, KZip::ZipVerification verification = KZip::ZipVerification::Always) {
+        KZip::ZipArchive archive;
+        archive.open(archiveName, mode);
+        archive.setVerification(verification);
+
+        uint64_t bytes = 0;
+        string   data;
+        auto     time = timeMilliseconds([&]() {
+            for (const auto& item : archive.entries()) {
+                if (reuseContainer) {
+                    item.entry().readInto(data);
+                    bytes += data.size();
+                }
+                else
+                    bytes += item.entry().getData<string>().size();
+            }
+        });
+        if (bytes == 0) throw KZip::ZipRuntimeError("Unable to read " + archiveName);
+        return time;
+    };
+
+    cout << "Entries: " << count << endl;
+    cout << "  read all entries (file I/O):                " << timeToReadAll(KZip::OpenMode::Default, false) << " ms" << endl;
+    cout << "  read all entries (memory mapped):           " << timeToReadAll(KZip::OpenMode::MemoryMapped, false) << " ms" << endl;
+    cout << "  read all entries (file I/O, readInto):      " << timeToReadAll(KZip::OpenMode::Default, true) << " ms" << endl;
+    cout << "  read all entries (memory mapped, readInto): " << timeToReadAll(KZip::OpenMode::MemoryMapped, true) << " ms" << endl;
+    cout << "  read all entries (memory mapped, readInto, no verification): "
+         << timeToReadAll(KZip::OpenMode::MemoryMapped, true, KZip::ZipVerification::Never) << " ms" << endl;
+
+    remove(archiveName.c_str());
+    return 0;
+}
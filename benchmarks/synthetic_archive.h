@@ -0,0 +1,50 @@
+#ifndef KZIP_SYNTHETIC_ARCHIVE_H
+#define KZIP_SYNTHETIC_ARCHIVE_H
+
+#include <KZip.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Generate the name of entry number i in a synthetic archive.
+ * @details The entries are spread over 100 folders with 100 subfolders each, to resemble a realistic archive layout.
+ */
+inline std::string syntheticEntryName(uint64_t i)
+{
+    return "folder" + std::to_string(i % 100) + "/sub" + std::to_string((i / 100) % 100) + "/entry" + std::to_string(i) + ".txt";
+}
+
+/**
+ * @brief Create an archive with the given number of small, stored entries.
+ * @details The archive is written directly through miniz, without compression, so that even archives with millions of
+ * entries can be generated in a few seconds.
+ */
+inline void createSyntheticArchive(const std::string& path, uint64_t entryCount)
+{
+    mz_zip_archive archive = mz_zip_archive();
+    if (!mz_zip_writer_init_file(&archive, path.c_str(), 0)) throw KZip::ZipRuntimeError("Unable to create " + path);
+
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        auto name = syntheticEntryName(i);
+        auto data = "data for entry " + std::to_string(i);
+        if (!mz_zip_writer_add_mem(&archive, name.c_str(), data.data(), data.size(), MZ_NO_COMPRESSION))
+            throw KZip::ZipRuntimeError(mz_zip_get_error_string(archive.m_last_error));
+    }
+
+    mz_zip_writer_finalize_archive(&archive);
+    mz_zip_writer_end(&archive);
+}
+
+/**
+ * @brief Measure the wall clock time (in milliseconds) spent calling the given function.
+ */
+template<typename Func>
+double timeMilliseconds(Func&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif    // KZIP_SYNTHETIC_ARCHIVE_H
@@ -6,7 +6,9 @@
 #include "test-data-text.hpp"
 #include <KZip.hpp>
 #include <catch.hpp>
+#include <cstring>
 #include <deque>
+#include <map>
 
 // Add binary file to archive
 // Add folders to archive
@@ -625,4 +627,1464 @@ TEST_CASE("TEST 5: ADD & EXTRACT ENTRIES") {
 //    SECTION("Entry copy") {
 //        REQUIRE(false);
 //    }
-//}
\ No newline at end of file
+//}
+TEST_CASE("TEST 6: Entry Lookup in Large Archive") {
+
+    KZip::ZipArchive archive;
+    std::string archivePath = "./TestArchive.zip";
+    archive.create(archivePath);
+
+    // ===== Add a large number of entries, spread across a number of folders.
+    const int entryCount = 5000;
+    for (int i = 0; i < entryCount; ++i)
+        archive.addEntry("Folder " + std::to_string(i % 10) + "/file " + std::to_string(i) + ".txt") = std::to_string(i);
+
+    SECTION("#01: Look up all entries") {
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Directories) == 10);
+        for (int i = 0; i < entryCount; ++i) {
+            auto name = "Folder " + std::to_string(i % 10) + "/file " + std::to_string(i) + ".txt";
+            REQUIRE(archive.hasEntry(name));
+            REQUIRE(archive.entry(name).name() == name);
+        }
+        REQUIRE_FALSE(archive.hasEntry("Folder 0/file 1.txt"));
+        REQUIRE_THROWS(archive.entry("Folder 0/file 1.txt"));
+    }
+
+    SECTION("#02: Delete, re-add and rename entries") {
+        for (int i = 0; i < entryCount; i += 2)
+            archive.deleteEntry("Folder " + std::to_string(i % 10) + "/file " + std::to_string(i) + ".txt");
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount / 2);
+        REQUIRE_FALSE(archive.hasEntry("Folder 0/file 0.txt"));
+        REQUIRE(archive.hasEntry("Folder 1/file 1.txt"));
+
+        archive.addEntry("Folder 0/file 0.txt") = std::string("re-added");
+        REQUIRE(archive.hasEntry("Folder 0/file 0.txt"));
+        REQUIRE(archive.entry("Folder 0/file 0.txt").getData<std::string>() == "re-added");
+
+        archive.entry("Folder 1/file 1.txt").setName("Folder 0/file 0.txt");
+        REQUIRE_FALSE(archive.hasEntry("Folder 1/file 1.txt"));
+        REQUIRE(archive.entry("Folder 0/file 0.txt").getData<std::string>() == "1");
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount / 2);
+
+        archive.save();
+        archive.close();
+        archive.open(archivePath);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount / 2);
+        REQUIRE(archive.entry("Folder 3/file 3.txt").getData<std::string>() == "3");
+        REQUIRE_FALSE(archive.hasEntry("Folder 2/file 2.txt"));
+    }
+
+    SECTION("#03: List and count entries in folders") {
+        REQUIRE(archive.entryCount("Folder 3/") == entryCount / 10);
+        REQUIRE(archive.entryCount("Folder 3/", KZip::ZipFlags::Files | KZip::ZipFlags::Directories) == entryCount / 10 + 1);
+        REQUIRE(archive.entryCount("Folder 3/file 3") == 112);
+        REQUIRE(archive.entryCount("Folder 31/") == 0);
+
+        auto names = archive.entryNames("Folder 3/");
+        REQUIRE(names.size() == entryCount / 10);
+        REQUIRE(std::is_sorted(names.begin(), names.end()));
+        REQUIRE(std::all_of(names.begin(), names.end(), [](const std::string& name) { return name.rfind("Folder 3/", 0) == 0; }));
+
+        // ===== Check that the folder listing is kept up to date when entries are added, deleted and renamed.
+        archive.addEntry("Folder 3/new file.txt") = std::string("new");
+        archive.deleteEntry("Folder 3/file 3.txt");
+        archive.entry("Folder 3/file 13.txt").setName("Folder 4/file 13.txt");
+        REQUIRE(archive.entryCount("Folder 3/") == entryCount / 10 - 1);
+        REQUIRE(archive.entryCount("Folder 4/") == entryCount / 10 + 1);
+
+        names = archive.entryNames("Folder 3/");
+        REQUIRE(std::find(names.begin(), names.end(), "Folder 3/new file.txt") != names.end());
+        REQUIRE(std::find(names.begin(), names.end(), "Folder 3/file 3.txt") == names.end());
+        REQUIRE(std::find(names.begin(), names.end(), "Folder 3/file 13.txt") == names.end());
+    }
+
+    SECTION("#04: Open archive in lazy mode") {
+        archive.save();
+        archive.close();
+        archive.open(archivePath, KZip::OpenMode::Lazy);
+
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+        REQUIRE(archive.entryCount("Folder 7/") == entryCount / 10);
+        REQUIRE(archive.hasEntry("Folder 7/file 17.txt"));
+        REQUIRE(archive.entry("Folder 7/file 17.txt").getData<std::string>() == "17");
+        REQUIRE(archive.entry("Folder 7/file 17.txt").metadata().uncompressedSize() == 2);
+
+        // ===== Modify the archive, including entries that haven't been loaded, and check that it is saved correctly.
+        archive.entry("Folder 8/file 18.txt").setName("Folder 8/renamed.txt");
+        archive.entry("Folder 8/file 28.txt") = std::string("modified");
+        archive.deleteEntry("Folder 8/file 38.txt");
+        archive.save();
+        archive.close();
+
+        archive.open(archivePath, KZip::OpenMode::Lazy);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount - 1);
+        REQUIRE(archive.entry("Folder 8/file 28.txt").getData<std::string>() == "modified");
+        REQUIRE(archive.entry("Folder 8/file 48.txt").getData<std::string>() == "48");
+        REQUIRE_FALSE(archive.hasEntry("Folder 8/file 38.txt"));
+    }
+
+    SECTION("#05: Entry metadata after overwrite, rename and compaction") {
+        auto& entry = archive.entry("Folder 5/file 5.txt");
+        REQUIRE(entry.metadata().name() == "Folder 5/file 5.txt");
+        REQUIRE(entry.getData<std::string>() == "5");
+
+        // ===== Overwriting an entry keeps the ZipEntryProxy object valid, but resets the data.
+        archive.addEntry("Folder 5/file 5.txt") = std::string("overwritten");
+        REQUIRE(entry.getData<std::string>() == "overwritten");
+        REQUIRE(entry.getData<std::string>().size() == 11);
+
+        // ===== Delete most entries and add new ones, so that the entry table is compacted.
+        for (int i = 0; i < entryCount; ++i)
+            if (i != 5) archive.deleteEntry("Folder " + std::to_string(i % 10) + "/file " + std::to_string(i) + ".txt");
+        for (int i = 0; i < entryCount; ++i) archive.addEntry("New/file " + std::to_string(i) + ".txt") = std::to_string(i);
+
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount + 1);
+        REQUIRE(entry.name() == "Folder 5/file 5.txt");
+        REQUIRE(entry.getData<std::string>() == "overwritten");
+        entry.setName("Folder 5/renamed.txt");
+        REQUIRE(archive.entry("Folder 5/renamed.txt").metadata().name() == "Folder 5/renamed.txt");
+        REQUIRE(archive.entry("New/file 4999.txt").getData<std::string>() == "4999");
+
+        archive.save();
+        archive.close();
+        archive.open(archivePath);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount + 1);
+        REQUIRE(archive.entry("Folder 5/renamed.txt").getData<std::string>() == "overwritten");
+        REQUIRE(archive.entry("New/file 123.txt").getData<std::string>() == "123");
+    }
+
+    SECTION("#06: Add entries in bulk") {
+        std::vector<std::pair<std::string, std::string>> entries;
+        for (int i = 0; i < entryCount; ++i)
+            entries.emplace_back("Bulk/Folder " + std::to_string(i % 7) + "/Sub " + std::to_string(i % 3) + "/file " + std::to_string(i) + ".txt", std::to_string(i));
+        archive.addEntries(entries);
+
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == 2 * entryCount);
+        REQUIRE(archive.entryCount("Bulk/", KZip::ZipFlags::Directories) == 1 + 7 + 7 * 3);
+        REQUIRE(archive.entry("Bulk/Folder 6/Sub 2/file 20.txt").getData<std::string>() == "20");
+
+        // ===== Folder entries are not saved, but are added again for the entries in them when the archive is opened.
+        archive.save();
+        archive.close();
+        archive.open(archivePath);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == 2 * entryCount);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Directories) == 10 + 1 + 7 + 7 * 3);
+        REQUIRE(archive.hasEntry("Bulk/Folder 6/Sub 2/"));
+    }
+
+    SECTION("#07: Iterate through entries without copying names") {
+        auto files = archive.entries();
+        REQUIRE(std::distance(files.begin(), files.end()) == entryCount);
+        REQUIRE(std::all_of(files.begin(), files.end(), [](const KZip::ZipEntryView& item) { return !item.metadata().isDirectory(); }));
+
+        auto folders = archive.entries(KZip::ZipFlags::Directories);
+        REQUIRE(std::count_if(folders.begin(), folders.end(), [](const auto& item) { return item.name().back() == '/'; }) == 10);
+
+        // ===== With a path, the entries are visited in sorted order, and match the names listed by entryNames().
+        auto names = archive.entryNames("Folder 3/");
+        auto index = std::size_t { 0 };
+        for (const auto& item : archive.entries("Folder 3/")) {
+            REQUIRE(item.name() == names.at(index++));
+            REQUIRE(item.metadata().name() == item.name());
+        }
+        REQUIRE(index == names.size());
+
+        // ===== The ZipEntryProxy object can be retrieved from the view.
+        auto range = archive.entries("Folder 4/");
+        auto found = std::find_if(range.begin(), range.end(), [](const auto& item) { return item.name() == "Folder 4/file 14.txt"; });
+        REQUIRE(found != range.end());
+        REQUIRE(found->entry().getData<std::string>() == "14");
+        REQUIRE(&found->entry() == &archive.entry("Folder 4/file 14.txt"));
+
+        auto empty = archive.entries("Folder 31/");
+        REQUIRE(empty.begin() == empty.end());
+    }
+    SECTION("#08: Open archive using a sidecar index file") {
+        archive.save();
+        archive.close();
+        auto indexPath = archivePath + ".kzidx";
+        std::filesystem::remove(indexPath);
+
+        // ===== The index file is written when the archive is opened for the first time, and used when it is reopened.
+        archive.open(archivePath, KZip::OpenMode::Indexed);
+        REQUIRE(std::filesystem::exists(indexPath));
+        archive.close();
+
+        archive.open(archivePath, KZip::OpenMode::Indexed | KZip::OpenMode::Lazy);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Directories) == 10);
+        REQUIRE(archive.entryCount("Folder 7/") == entryCount / 10);
+        REQUIRE(archive.entry("Folder 7/file 17.txt").getData<std::string>() == "17");
+        REQUIRE(archive.entry("Folder 7/file 17.txt").metadata().uncompressedSize() == 2);
+        REQUIRE(std::distance(archive.find("Folder 3/*").begin(), archive.find("Folder 3/*").end()) == entryCount / 10);
+
+        // ===== When the archive is modified, the index file is stale, and is rebuilt.
+        archive.entry("Folder 8/file 18.txt") = std::string("modified");
+        archive.deleteEntry("Folder 8/file 38.txt");
+        archive.addEntry("New/file.txt") = std::string("new");
+        archive.save();
+        archive.close();
+
+        archive.open(archivePath, KZip::OpenMode::Indexed);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+        REQUIRE(archive.entry("Folder 8/file 18.txt").getData<std::string>() == "modified");
+        REQUIRE_FALSE(archive.hasEntry("Folder 8/file 38.txt"));
+        REQUIRE(archive.entry("New/file.txt").getData<std::string>() == "new");
+        archive.close();
+
+        // ===== A damaged index file is ignored, and rebuilt.
+        std::filesystem::resize_file(indexPath, std::filesystem::file_size(indexPath) / 2);
+        archive.open(archivePath, KZip::OpenMode::Indexed);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+        REQUIRE(archive.entry("Folder 8/file 48.txt").getData<std::string>() == "48");
+        archive.close();
+
+        archive.open(archivePath, KZip::OpenMode::Indexed);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+        REQUIRE(archive.entry("New/file.txt").getData<std::string>() == "new");
+        archive.close();
+
+        // ===== An index file that matches the archive file, but refers to slots or names out of bounds, is ignored and
+        // rebuilt. The header is 88 bytes, with the number of records at offset 48 and the size of the name arena at 56;
+        // it is followed by the 64 byte records (with the name offset at offset 24), the name arena and the sorted slots.
+        auto readWord = [&](std::streamoff offset) {
+            std::ifstream file(indexPath, std::ios::binary);
+            uint64_t      value = 0;
+            file.seekg(offset);
+            file.read(reinterpret_cast<char*>(&value), sizeof value);
+            return value;
+        };
+        auto corrupt = [&](std::streamoff offset, uint64_t value) {
+            archive.open(archivePath, KZip::OpenMode::Indexed);
+            archive.close();
+            std::fstream file(indexPath, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(offset);
+            file.write(reinterpret_cast<const char*>(&value), sizeof value);
+        };
+        auto sortedOffset = static_cast<std::streamoff>(88 + readWord(48) * 64 + readWord(56));
+        for (auto [offset, value] : { std::pair<std::streamoff, uint64_t> { sortedOffset, 1000000 },
+                                      std::pair<std::streamoff, uint64_t> { 88 + 24, uint64_t { 1 } << 40 },
+                                      std::pair<std::streamoff, uint64_t> { 56, uint64_t { 1 } << 60 } }) {
+            corrupt(offset, value);
+            archive.open(archivePath, KZip::OpenMode::Indexed);
+            REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+            REQUIRE(archive.entryCount("Folder 7/") == entryCount / 10);
+            REQUIRE(archive.entry("New/file.txt").getData<std::string>() == "new");
+            archive.close();
+            REQUIRE(readWord(offset) != value);
+        }
+        std::filesystem::remove(indexPath);
+    }
+    SECTION("#09: Open archive in memory mapped mode") {
+        archive.save();
+        archive.close();
+
+        archive.open(archivePath, KZip::OpenMode::MemoryMapped);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+        for (int i = 0; i < entryCount; i += 7) {
+            auto name = "Folder " + std::to_string(i % 10) + "/file " + std::to_string(i) + ".txt";
+            REQUIRE(archive.entry(name).getData<std::string>() == std::to_string(i));
+        }
+
+        // ===== The mapping is released before the archive file is replaced when saving.
+        archive.entry("Folder 8/file 18.txt") = std::string("modified");
+        archive.deleteEntry("Folder 8/file 38.txt");
+        archive.save();
+        REQUIRE(archive.entry("Folder 8/file 18.txt").getData<std::string>() == "modified");
+        REQUIRE(archive.entry("Folder 8/file 28.txt").getData<std::string>() == "28");
+        archive.close();
+
+        archive.open(archivePath, KZip::OpenMode::MemoryMapped | KZip::OpenMode::Lazy);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount - 1);
+        REQUIRE(archive.entry("Folder 8/file 18.txt").getData<std::string>() == "modified");
+        REQUIRE(archive.entry("Folder 8/file 48.txt").metadata().uncompressedSize() == 2);
+        REQUIRE_FALSE(archive.hasEntry("Folder 8/file 38.txt"));
+    }
+}
+
+TEST_CASE("TEST 7: Archive with Duplicate Entries") {
+
+    // ===== Write an archive with non-adjacent duplicate names directly with miniz, as if it had been appended to.
+    std::string archivePath = "./DuplicateEntries.zip";
+    mz_zip_archive writer = mz_zip_archive();
+    mz_zip_writer_init_file(&writer, archivePath.c_str(), 0);
+    for (const auto& [name, data] : std::vector<std::pair<std::string, std::string>> { { "a.txt", "old a" },
+                                                                                        { "b.txt", "old b" },
+                                                                                        { "c.txt", "c" },
+                                                                                        { "a.txt", "new a" },
+                                                                                        { "b.txt", "new b" },
+                                                                                        { "a.txt", "newest a" } })
+        mz_zip_writer_add_mem(&writer, name.c_str(), data.data(), data.size(), MZ_DEFAULT_COMPRESSION);
+    mz_zip_writer_finalize_archive(&writer);
+    mz_zip_writer_end(&writer);
+
+    SECTION("#01: Only the newest entries are retained") {
+        for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::Lazy, KZip::OpenMode::MemoryMapped }) {
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode);
+            REQUIRE(archive.shadowedEntryCount() == 3);
+            REQUIRE(archive.entryCount() == 3);
+            REQUIRE(archive.entryNames() == std::vector<std::string> { "c.txt", "b.txt", "a.txt" });
+            REQUIRE(archive.entry("a.txt").getData<std::string>() == "newest a");
+            REQUIRE(archive.entry("b.txt").getData<std::string>() == "new b");
+        }
+    }
+
+    SECTION("#02: Shadowed entries are dropped when saving") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.save();
+        archive.close();
+
+        archive.open(archivePath);
+        REQUIRE(archive.shadowedEntryCount() == 0);
+        REQUIRE(archive.entryCount() == 3);
+        REQUIRE(archive.entry("a.txt").getData<std::string>() == "newest a");
+    }
+}
+
+TEST_CASE("TEST 8: Zip64 Archive with Many Entries and Large Entries", "[.][stress]") {
+
+    // ===== Write an entry larger than 4 GB directly with miniz, streaming the (zero) data from a callback.
+    std::string archivePath = "./Zip64Archive.zip";
+    const uint64_t largeSize = (uint64_t { 1 } << 32) + 12345;
+    mz_zip_archive writer = mz_zip_archive();
+    mz_zip_writer_init_file_v2(&writer, archivePath.c_str(), 0, MZ_ZIP_FLAG_WRITE_ZIP64);
+    auto readZeros = [](void* opaque, mz_uint64 offset, void* buffer, size_t size) -> size_t {
+        auto remaining = *static_cast<const uint64_t*>(opaque) - offset;
+        if (remaining < size) size = static_cast<size_t>(remaining);
+        std::memset(buffer, 0, size);
+        return size;
+    };
+    auto sizeOpaque = largeSize;
+    REQUIRE(mz_zip_writer_add_read_buf_callback(&writer, "large.bin", readZeros, &sizeOpaque, largeSize, nullptr, nullptr, 0, 1, nullptr, 0, nullptr, 0));
+    mz_zip_writer_finalize_archive(&writer);
+    mz_zip_writer_end(&writer);
+
+    // ===== Add more than 65535 entries, and save the archive.
+    const uint64_t entryCount = 70000;
+    {
+        KZip::ZipArchive archive(archivePath);
+        REQUIRE(archive.entry("large.bin").metadata().uncompressedSize() == largeSize);
+
+        std::vector<std::pair<std::string, std::string>> entries;
+        for (uint64_t i = 0; i < entryCount; ++i) entries.emplace_back("Folder " + std::to_string(i % 10) + "/file " + std::to_string(i) + ".txt", std::to_string(i));
+        archive.addEntries(entries);
+        REQUIRE(archive.entryCount() == entryCount + 1);
+        archive.save();
+    }
+
+    // ===== Open, enumerate and save the archive again, in both open modes.
+    for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::Lazy, KZip::OpenMode::MemoryMapped }) {
+        KZip::ZipArchive archive(archivePath, mode);
+        REQUIRE(archive.entryCount() == entryCount + 1);
+        REQUIRE(archive.entryCount(KZip::ZipFlags::Directories) == 10);
+        REQUIRE(archive.entryCount("Folder 7/") == entryCount / 10);
+
+        auto files = archive.entries();
+        REQUIRE(static_cast<uint64_t>(std::distance(files.begin(), files.end())) == entryCount + 1);
+        REQUIRE(archive.entry("large.bin").metadata().uncompressedSize() == largeSize);
+        REQUIRE(archive.entry("Folder 9/file 69999.txt").getData<std::string>() == "69999");
+
+        archive.entry("Folder 0/file 0.txt") = std::string("modified");
+        archive.save();
+        REQUIRE(archive.entry("Folder 0/file 0.txt").getData<std::string>() == "modified");
+        REQUIRE(archive.entry("large.bin").metadata().uncompressedSize() == largeSize);
+    }
+
+    std::remove(archivePath.c_str());
+}
+
+TEST_CASE("TEST 9: Find Entries Using Glob Patterns") {
+
+    KZip::ZipArchive archive;
+    std::string archivePath = "./TestArchive.zip";
+    archive.create(archivePath);
+
+    for (const auto* name : { "[Content_Types].xml",
+                              "_rels/.rels",
+                              "docProps/app.xml",
+                              "xl/workbook.xml",
+                              "xl/_rels/workbook.xml.rels",
+                              "xl/worksheets/sheet1.xml",
+                              "xl/worksheets/sheet2.xml",
+                              "xl/worksheets/sheet10.xml",
+                              "xl/worksheets/_rels/sheet1.xml.rels",
+                              "xl/media/image1.png",
+                              "xl/media/sub/image2.png",
+                              "image3.png" })
+        archive.addEntry(name) = std::string(name);
+
+    auto findNames = [&](const std::string& pattern, KZip::ZipFlags flags = KZip::ZipFlags::Files) {
+        std::vector<std::string> result;
+        for (const auto& item : archive.find(pattern, flags)) result.emplace_back(item.name());
+        return result;
+    };
+
+    SECTION("#01: Wildcards within a folder") {
+        REQUIRE(findNames("xl/worksheets/*.xml") == std::vector<std::string> { "xl/worksheets/sheet1.xml", "xl/worksheets/sheet10.xml", "xl/worksheets/sheet2.xml" });
+        REQUIRE(findNames("xl/worksheets/sheet?.xml") == std::vector<std::string> { "xl/worksheets/sheet1.xml", "xl/worksheets/sheet2.xml" });
+        REQUIRE(findNames("xl/worksheets/sheet[!1].xml") == std::vector<std::string> { "xl/worksheets/sheet2.xml" });
+        REQUIRE(findNames("xl/*/*.png") == std::vector<std::string> { "xl/media/image1.png" });
+        REQUIRE(findNames("*.png") == std::vector<std::string> { "image3.png" });
+        REQUIRE(findNames("xl/workbook.xml") == std::vector<std::string> { "xl/workbook.xml" });
+        REQUIRE(findNames("xl/*.xml") == std::vector<std::string> { "xl/workbook.xml" });
+        REQUIRE(findNames("*/*.rels") == std::vector<std::string> { "_rels/.rels" });
+        REQUIRE(findNames("\\[Content_Types\\].xml") == std::vector<std::string> { "[Content_Types].xml" });
+        REQUIRE(findNames("[[]Content_Types].xml") == std::vector<std::string> { "[Content_Types].xml" });
+        REQUIRE(findNames("xl/charts/*.xml").empty());
+    }
+
+    SECTION("#02: Wildcards across folders") {
+        REQUIRE(findNames("**/*.png") == std::vector<std::string> { "image3.png", "xl/media/image1.png", "xl/media/sub/image2.png" });
+        REQUIRE(findNames("xl/**/*.rels") == std::vector<std::string> { "xl/_rels/workbook.xml.rels", "xl/worksheets/_rels/sheet1.xml.rels" });
+        REQUIRE(findNames("xl/**/sheet1.*") == std::vector<std::string> { "xl/worksheets/_rels/sheet1.xml.rels", "xl/worksheets/sheet1.xml" });
+        REQUIRE(findNames("**").size() == 12);
+    }
+
+    SECTION("#03: Folder entries") {
+        REQUIRE(findNames("xl/*/", KZip::ZipFlags::Directories) == std::vector<std::string> { "xl/_rels/", "xl/media/", "xl/worksheets/" });
+        REQUIRE(findNames("**/_rels/", KZip::ZipFlags::Directories) == std::vector<std::string> { "_rels/", "xl/_rels/", "xl/worksheets/_rels/" });
+        REQUIRE(findNames("xl/media/**", KZip::ZipFlags::Files | KZip::ZipFlags::Directories).size() == 4);
+    }
+
+    SECTION("#04: The range can be used with standard algorithms, and gives access to the entries") {
+        auto range = archive.find("xl/**/*.xml");
+        REQUIRE(std::distance(range.begin(), range.end()) == 4);
+
+        auto sheet = std::find_if(range.begin(), range.end(), [](const auto& item) { return item.name() == "xl/worksheets/sheet2.xml"; });
+        REQUIRE(sheet != range.end());
+        REQUIRE(sheet->entry().getData<std::string>() == "xl/worksheets/sheet2.xml");
+    }
+}
+
+TEST_CASE("TEST 10: Open Archive Using Multiple Threads") {
+
+    // ===== The archive must be large enough for the central directory to be split between threads.
+    const std::string archivePath = "./TestArchive.zip";
+    const int         entryCount  = 50000;
+    {
+        KZip::ZipArchive archive;
+        archive.create(archivePath);
+        for (int i = 0; i < entryCount; ++i)
+            archive.addEntry("Folder " + std::to_string(i % 13) + "/file " + std::to_string(i) + ".txt") = std::to_string(i);
+        archive.save();
+    }
+
+    KZip::ZipArchive reference;
+    reference.open(archivePath, KZip::OpenMode::Default, 1);
+
+    for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::Lazy, KZip::OpenMode::MemoryMapped }) {
+        for (std::size_t threads : { 2, 4, 16 }) {
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode, threads);
+
+            REQUIRE(archive.entryCount(KZip::ZipFlags::Files) == entryCount);
+            REQUIRE(archive.entryCount(KZip::ZipFlags::Directories) == 13);
+            REQUIRE(archive.entryNames("Folder 7/") == reference.entryNames("Folder 7/"));
+            REQUIRE(archive.entryNames(KZip::ZipFlags::Files) == reference.entryNames(KZip::ZipFlags::Files));
+            for (int i = 0; i < entryCount; i += 997) {
+                auto name = "Folder " + std::to_string(i % 13) + "/file " + std::to_string(i) + ".txt";
+                REQUIRE(archive.entry(name).metadata().index() == reference.entry(name).metadata().index());
+                REQUIRE(archive.entry(name).metadata().compressedSize() == reference.entry(name).metadata().compressedSize());
+                REQUIRE(archive.entry(name).getData<std::string>() == std::to_string(i));
+            }
+        }
+    }
+}
+
+TEST_CASE("TEST 11: Read Entries as Streams") {
+
+    const std::string archivePath = "./TestArchive.zip";
+
+    // ===== Create an archive with a large, compressible text entry, and a small entry.
+    std::string text;
+    for (int i = 0; i < 200000; ++i) text += "Line " + std::to_string(i) + " of the log file\n";
+    {
+        KZip::ZipArchive archive;
+        archive.create(archivePath);
+        archive.addEntry("log.txt") = text;
+        archive.addEntry("small.txt") = std::string("small");
+        archive.addEntry("empty.txt") = std::string();
+        archive.save();
+    }
+
+    KZip::ZipArchive archive;
+    archive.open(archivePath);
+
+    SECTION("#01: Read in chunks") {
+        auto reader = archive.entry("log.txt").openStream();
+        REQUIRE(reader.size() == text.size());
+
+        std::string result;
+        char        buffer[1000];
+        while (auto count = reader.read(buffer, sizeof buffer)) result.append(buffer, count);
+        REQUIRE(reader.eof());
+        REQUIRE(reader.position() == text.size());
+        REQUIRE(result == text);
+        REQUIRE(reader.read(buffer, sizeof buffer) == 0);
+
+        auto empty = archive.entry("empty.txt").openStream();
+        REQUIRE(empty.read(buffer, sizeof buffer) == 0);
+        REQUIRE(empty.eof());
+    }
+
+    SECTION("#02: Read using std::istream") {
+        KZip::ZipEntryStream stream(archive.entry("log.txt").openStream(), 4096);
+        int                  count = 0;
+        for (std::string line; std::getline(stream, line); ++count)
+            REQUIRE(line == "Line " + std::to_string(count) + " of the log file");
+        REQUIRE(count == 200000);
+        REQUIRE(stream.eof());
+        REQUIRE_FALSE(stream.bad());
+
+        KZip::ZipEntryStream small(archive.entry("small.txt").openStream());
+        std::string          word;
+        small >> word;
+        REQUIRE(word == "small");
+    }
+
+    SECTION("#03: Read new and modified entries") {
+        archive.addEntry("new.txt") = std::string("new data");
+        archive.entry("small.txt") = std::string("modified");
+        archive.addEntry("no data.txt");
+
+        KZip::ZipEntryStream stream(archive.entry("new.txt").openStream());
+        REQUIRE(std::string(std::istreambuf_iterator<char>(stream), {}) == "new data");
+        KZip::ZipEntryStream modified(archive.entry("small.txt").openStream());
+        REQUIRE(std::string(std::istreambuf_iterator<char>(modified), {}) == "modified");
+        REQUIRE(archive.entry("no data.txt").openStream().size() == 0);
+    }
+
+    SECTION("#04: Corrupted data is detected") {
+        archive.close();
+
+        // ===== Create an archive with an incompressible entry, and change a byte in the middle of its data.
+        std::string data(100000, '\0');
+        std::mt19937 generator(42);
+        for (auto& c : data) c = static_cast<char>(generator());
+        archive.create(archivePath);
+        archive.addEntry("x") = data;
+        archive.save();
+        archive.close();
+        {
+            std::fstream file(archivePath, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(50000);
+            file.put(static_cast<char>(file.peek() ^ 0x55));
+        }
+
+        archive.open(archivePath);
+        auto reader = archive.entry("x").openStream();
+        REQUIRE_THROWS_AS([&]() { char buffer[4096]; while (reader.read(buffer, sizeof buffer) > 0) {} }(), KZip::ZipRuntimeError);
+
+        // ===== Reading again after the error fails as well.
+        char buffer[4096];
+        REQUIRE_THROWS_AS(reader.read(buffer, sizeof buffer), KZip::ZipLogicError);
+
+        // ===== When reading through the stream, the error sets the badbit of the stream, also when reading again.
+        KZip::ZipEntryStream stream(archive.entry("x").openStream());
+        std::string          result(data.size(), '\0');
+        stream.read(result.data(), static_cast<std::streamsize>(result.size()));
+        REQUIRE(stream.bad());
+        stream.clear();
+        stream.read(result.data(), static_cast<std::streamsize>(result.size()));
+        REQUIRE(stream.bad());
+    }
+}
+
+TEST_CASE("TEST 12: Read Entries into Caller-Provided Buffers") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    std::string       text;
+    for (int i = 0; i < 20000; ++i) text += "Line " + std::to_string(i) + "\n";
+    {
+        KZip::ZipArchive archive;
+        archive.create(archivePath);
+        archive.addEntry("large.txt") = text;
+        for (int i = 0; i < 100; ++i) archive.addEntry("small/" + std::to_string(i) + ".txt") = std::to_string(i);
+        archive.save();
+    }
+
+    for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::MemoryMapped }) {
+        KZip::ZipArchive archive;
+        archive.open(archivePath, mode);
+
+        // ===== Read into a raw buffer.
+        std::vector<char> buffer(text.size() + 100);
+        REQUIRE(archive.entry("large.txt").readInto(buffer.data(), buffer.size()) == text.size());
+        REQUIRE(std::string(buffer.data(), text.size()) == text);
+        REQUIRE_THROWS_AS(archive.entry("large.txt").readInto(buffer.data(), text.size() - 1), KZip::ZipLogicError);
+
+        // ===== Read into a reused container; once its capacity is sufficient, it is not reallocated.
+        std::string data;
+        data.reserve(1024);
+        const auto* storage = data.data();
+        for (int i = 0; i < 100; ++i) {
+            archive.entry("small/" + std::to_string(i) + ".txt").readInto(data);
+            REQUIRE(data == std::to_string(i));
+            REQUIRE(data.data() == storage);
+        }
+
+        std::vector<unsigned char> bytes;
+        archive.entry("large.txt").readInto(bytes);
+        REQUIRE(std::string(bytes.begin(), bytes.end()) == text);
+
+        // ===== New entries, and entries without data.
+        archive.addEntry("new.txt") = std::string("new");
+        archive.addEntry("no data.txt");
+        archive.entry("new.txt").readInto(data);
+        REQUIRE(data == "new");
+        archive.entry("no data.txt").readInto(data);
+        REQUIRE(data.empty());
+        REQUIRE(archive.entry("small/").readInto(buffer.data(), 0) == 0);
+    }
+}
+
+TEST_CASE("TEST 13: Cache of Decompressed Entry Data") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    {
+        KZip::ZipArchive archive;
+        archive.create(archivePath);
+        for (int i = 0; i < 10; ++i) archive.addEntry("entry " + std::to_string(i) + ".txt") = std::string(1000, static_cast<char>('a' + i));
+        archive.save();
+    }
+
+    KZip::ZipArchive archive;
+    archive.open(archivePath);
+
+    SECTION("#01: The cache is disabled by default") {
+        REQUIRE(archive.entry("entry 0.txt").getData<std::string>() == std::string(1000, 'a'));
+        REQUIRE(archive.entry("entry 0.txt").getData<std::string>() == std::string(1000, 'a'));
+        auto statistics = archive.cacheStatistics();
+        REQUIRE(statistics.hits == 0);
+        REQUIRE(statistics.misses == 0);
+        REQUIRE(statistics.entryCount == 0);
+    }
+
+    SECTION("#02: Hits, misses and least recently used eviction") {
+        archive.setCacheSize(3500);
+        for (int i = 0; i < 3; ++i) archive.entry("entry " + std::to_string(i) + ".txt").getData<std::string>();
+        REQUIRE(archive.cacheStatistics().misses == 3);
+        REQUIRE(archive.cacheStatistics().size == 3000);
+
+        // ===== Reading entry 0 again makes entry 1 the least recently used, which is evicted when entry 3 is read.
+        REQUIRE(archive.entry("entry 0.txt").getData<std::string>() == std::string(1000, 'a'));
+        REQUIRE(archive.entry("entry 3.txt").getData<std::string>() == std::string(1000, 'd'));
+        REQUIRE(archive.cacheStatistics().hits == 1);
+        REQUIRE(archive.cacheStatistics().entryCount == 3);
+
+        std::string data;
+        archive.entry("entry 0.txt").readInto(data);
+        archive.entry("entry 2.txt").readInto(data);
+        REQUIRE(data == std::string(1000, 'c'));
+        REQUIRE(archive.cacheStatistics().hits == 3);
+        archive.entry("entry 1.txt").readInto(data);
+        REQUIRE(data == std::string(1000, 'b'));
+        REQUIRE(archive.cacheStatistics().misses == 5);
+
+        // ===== Reducing the capacity evicts entries; entries larger than the capacity are not cached.
+        archive.setCacheSize(1500);
+        REQUIRE(archive.cacheStatistics().entryCount == 1);
+        REQUIRE(archive.cacheStatistics().size == 1000);
+        archive.setCacheSize(500);
+        archive.entry("entry 4.txt").getData<std::string>();
+        REQUIRE(archive.cacheStatistics().entryCount == 0);
+
+        archive.clearCache();
+        REQUIRE(archive.cacheStatistics().hits == 0);
+        REQUIRE(archive.cacheStatistics().capacity == 500);
+    }
+
+    SECTION("#03: Cached data is discarded when an entry is modified, and when the archive is saved") {
+        archive.setCacheSize(1000000);
+        archive.entry("entry 5.txt").getData<std::string>();
+        archive.entry("entry 6.txt").getData<std::string>();
+        REQUIRE(archive.cacheStatistics().entryCount == 2);
+
+        archive.entry("entry 5.txt") = std::string("modified");
+        REQUIRE(archive.cacheStatistics().entryCount == 1);
+        REQUIRE(archive.entry("entry 5.txt").getData<std::string>() == "modified");
+
+        archive.save();
+        REQUIRE(archive.cacheStatistics().entryCount == 0);
+        REQUIRE(archive.entry("entry 5.txt").getData<std::string>() == "modified");
+        REQUIRE(archive.entry("entry 5.txt").getData<std::string>() == "modified");
+        REQUIRE(archive.entry("entry 6.txt").getData<std::string>() == std::string(1000, 'g'));
+        REQUIRE(archive.cacheStatistics().hits == 1);
+    }
+
+    SECTION("#04: Cached data is discarded when an entry is overwritten or deleted") {
+        archive.setCacheSize(1000000);
+        for (int i = 7; i < 10; ++i) archive.entry("entry " + std::to_string(i) + ".txt").getData<std::string>();
+        REQUIRE(archive.cacheStatistics().entryCount == 3);
+
+        archive.addEntry("entry 7.txt") = std::string("overwritten");
+        REQUIRE(archive.cacheStatistics().entryCount == 2);
+        REQUIRE(archive.cacheStatistics().size == 2000);
+        REQUIRE(archive.entry("entry 7.txt").getData<std::string>() == "overwritten");
+
+        archive.deleteEntry("entry 8.txt");
+        REQUIRE(archive.cacheStatistics().entryCount == 1);
+        REQUIRE(archive.cacheStatistics().size == 1000);
+    }
+}
+
+TEST_CASE("TEST 14: Extract All Entries") {
+
+    const std::string           archivePath = "./TestArchive.zip";
+    const std::filesystem::path targetPath  = "./TestExtract";
+    std::filesystem::remove_all(targetPath);
+    {
+        KZip::ZipArchive archive;
+        archive.create(archivePath);
+        for (int i = 0; i < 50; ++i)
+            archive.addEntry("Folder " + std::to_string(i % 5) + "/Sub/file " + std::to_string(i) + ".txt") = std::string(i * 1000, static_cast<char>('a' + i % 26));
+        archive.addEntry("root.txt") = std::string("root");
+        archive.save();
+    }
+
+    auto readFile = [](const std::filesystem::path& path) {
+        std::ifstream stream(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream), {});
+    };
+
+    SECTION("#01: Extract using multiple threads") {
+        for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::MemoryMapped }) {
+            std::filesystem::remove_all(targetPath);
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode);
+            archive.addEntry("New/new.txt") = std::string("new");
+            archive.extractAll(targetPath, { 4 });
+
+            for (int i = 0; i < 50; ++i) {
+                auto path = targetPath / ("Folder " + std::to_string(i % 5)) / "Sub" / ("file " + std::to_string(i) + ".txt");
+                REQUIRE(readFile(path) == std::string(i * 1000, static_cast<char>('a' + i % 26)));
+            }
+            REQUIRE(readFile(targetPath / "root.txt") == "root");
+            REQUIRE(readFile(targetPath / "New" / "new.txt") == "new");
+            REQUIRE(std::filesystem::is_directory(targetPath / "Folder 4" / "Sub"));
+        }
+    }
+
+    SECTION("#02: Existing files are kept if overwriting is disabled") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.extractAll(targetPath);
+        {
+            std::ofstream stream(targetPath / "root.txt");
+            stream << "changed";
+        }
+
+        archive.extractAll(targetPath, { 1, false });
+        REQUIRE(readFile(targetPath / "root.txt") == "changed");
+        archive.extractAll(targetPath, { 1, true });
+        REQUIRE(readFile(targetPath / "root.txt") == "root");
+    }
+
+    SECTION("#03: Entries can't be extracted outside the target directory") {
+        mz_zip_archive writer = mz_zip_archive();
+        mz_zip_writer_init_file(&writer, archivePath.c_str(), 0);
+        mz_zip_writer_add_mem(&writer, "safe.txt", "safe", 4, MZ_DEFAULT_COMPRESSION);
+        mz_zip_writer_add_mem(&writer, "../unsafe.txt", "unsafe", 6, MZ_DEFAULT_COMPRESSION);
+        mz_zip_writer_finalize_archive(&writer);
+        mz_zip_writer_end(&writer);
+
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        REQUIRE_THROWS_AS(archive.extractAll(targetPath), KZip::ZipRuntimeError);
+        REQUIRE_FALSE(std::filesystem::exists(targetPath / "safe.txt"));
+        REQUIRE_FALSE(std::filesystem::exists(targetPath.parent_path() / "unsafe.txt"));
+    }
+
+    std::filesystem::remove_all(targetPath);
+}
+
+TEST_CASE("TEST 15: Read Entries Concurrently") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    auto              contentOf   = [](int i) {
+        std::string content;
+        for (int j = 0; content.size() < static_cast<std::size_t>(2000 + i * 997); ++j) content += std::to_string(i * j) + (j % 7 ? " " : "\n");
+        return content;
+    };
+    {
+        KZip::ZipArchive archive;
+        archive.create(archivePath);
+        for (int i = 0; i < 100; ++i) archive.addEntry("Folder " + std::to_string(i % 10) + "/file " + std::to_string(i) + ".txt") = contentOf(i);
+        archive.save();
+    }
+
+    // ===== Each thread reads all entries, starting at a different entry, so that the threads read different parts of the
+    // archive file at the same time.
+    auto readAll = [&](const KZip::ZipArchive& archive, int threadCount, bool useStreams) {
+        std::atomic<int>         errorCount { 0 };
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < threadCount; ++thread) {
+            threads.emplace_back([&, thread]() {
+                for (int n = 0; n < 100; ++n) {
+                    auto        i     = (n + thread * 13) % 100;
+                    const auto& entry = archive.entry("Folder " + std::to_string(i % 10) + "/file " + std::to_string(i) + ".txt");
+                    std::string data;
+                    if (useStreams) {
+                        KZip::ZipEntryStream stream(entry.openStream());
+                        data.assign(std::istreambuf_iterator<char>(stream), {});
+                    }
+                    else
+                        data = entry.getData<std::string>();
+
+                    if (data != contentOf(i) || entry.metadata().uncompressedSize() != data.size()) ++errorCount;
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        return errorCount.load();
+    };
+
+    SECTION("#01: Read entries from multiple threads") {
+        for (auto mode : { KZip::OpenMode::Concurrent,
+                           KZip::OpenMode::Concurrent | KZip::OpenMode::Lazy,
+                           KZip::OpenMode::Concurrent | KZip::OpenMode::MemoryMapped }) {
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode);
+            REQUIRE(readAll(archive, 8, false) == 0);
+            REQUIRE(readAll(archive, 8, true) == 0);
+        }
+    }
+
+    SECTION("#02: Read entries from multiple threads through the cache") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath, KZip::OpenMode::Concurrent | KZip::OpenMode::Lazy);
+        archive.setCacheSize(100000);
+        REQUIRE(readAll(archive, 8, false) == 0);
+
+        auto statistics = archive.cacheStatistics();
+        REQUIRE(statistics.hits + statistics.misses == 800);
+        REQUIRE(statistics.size <= 100000);
+    }
+
+    SECTION("#03: The archive can be modified and saved after reading concurrently") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath, KZip::OpenMode::Concurrent);
+        REQUIRE(readAll(archive, 4, false) == 0);
+
+        archive.addEntry("new.txt") = std::string("new");
+        archive.save();
+        REQUIRE(archive.entry("new.txt").getData<std::string>() == "new");
+        REQUIRE(readAll(archive, 4, false) == 0);
+    }
+}
+
+TEST_CASE("TEST 16: Read Ranges of Entries") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    std::string       content;
+    for (int i = 0; content.size() < 3000000; ++i) content += "<row id=\"" + std::to_string(i) + "\">" + std::to_string(i * 7919 % 10007) + "</row>\n";
+    {
+        mz_zip_archive writer = mz_zip_archive();
+        mz_zip_writer_init_file(&writer, archivePath.c_str(), 0);
+        mz_zip_writer_add_mem(&writer, "deflated.xml", content.data(), content.size(), MZ_DEFAULT_COMPRESSION);
+        mz_zip_writer_add_mem(&writer, "stored.xml", content.data(), content.size(), MZ_NO_COMPRESSION);
+        mz_zip_writer_finalize_archive(&writer);
+        mz_zip_writer_end(&writer);
+    }
+
+    // ===== The ranges are read backwards, so that most reads resume from a checkpoint recorded by an earlier read.
+    auto readRanges = [&](const KZip::ZipEntryProxy& entry) {
+        auto errorCount = 0;
+        for (auto offset = static_cast<int64_t>(content.size()) - 1000; offset >= 0; offset -= 99991) {
+            for (std::size_t length : { 1, 100, 70000 }) {
+                if (entry.read<std::string>(offset, length) != content.substr(offset, length)) ++errorCount;
+            }
+        }
+        return errorCount;
+    };
+
+    SECTION("#01: Read ranges of deflated and stored entries") {
+        for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::MemoryMapped }) {
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode);
+            archive.setSeekInterval(64 * 1024);
+            REQUIRE(readRanges(archive.entry("deflated.xml")) == 0);
+            REQUIRE(readRanges(archive.entry("stored.xml")) == 0);
+        }
+    }
+
+    SECTION("#02: Read ranges at the end of the entry") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        const auto& entry = archive.entry("deflated.xml");
+        REQUIRE(entry.read<std::string>(content.size() - 10, 100) == content.substr(content.size() - 10));
+        REQUIRE(entry.read<std::string>(content.size(), 100).empty());
+        REQUIRE(entry.read<std::string>(content.size() + 100, 100).empty());
+        REQUIRE(entry.read<std::string>(0, 0).empty());
+        REQUIRE(entry.read<std::string>(0, content.size() + 100) == content);
+    }
+
+    SECTION("#03: Read ranges of modified entries") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.entry("deflated.xml").read<std::string>(2000000, 10);
+        archive.entry("deflated.xml") = std::string("modified data");
+        REQUIRE(archive.entry("deflated.xml").read<std::string>(9, 100) == "data");
+    }
+
+    SECTION("#04: Read ranges from multiple threads") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath, KZip::OpenMode::Concurrent);
+        archive.setSeekInterval(128 * 1024);
+
+        std::atomic<int>         errorCount { 0 };
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread)
+            threads.emplace_back([&]() { errorCount += readRanges(archive.entry("deflated.xml")); });
+        for (auto& thread : threads) thread.join();
+        REQUIRE(errorCount == 0);
+    }
+}
+
+TEST_CASE("TEST 17: Extract a List of Entries") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    auto              nameOf      = [](int i) { return "Folder " + std::to_string(i % 4) + "/file " + std::to_string(i) + ".txt"; };
+    auto              contentOf   = [](int i) { return std::string(i == 50 ? 5000000 : i * 100, static_cast<char>('a' + i % 26)) + std::to_string(i); };
+    {
+        mz_zip_archive writer = mz_zip_archive();
+        mz_zip_writer_init_file(&writer, archivePath.c_str(), 0);
+        for (int i = 0; i < 200; ++i) {
+            auto content = contentOf(i);
+            mz_zip_writer_add_mem(&writer, nameOf(i).c_str(), content.data(), content.size(), i % 3 ? MZ_DEFAULT_COMPRESSION : MZ_NO_COMPRESSION);
+        }
+        mz_zip_writer_finalize_archive(&writer);
+        mz_zip_writer_end(&writer);
+    }
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; i += 2) names.push_back(nameOf((i * 37) % 200));
+    names.emplace_back("Folder 1/");
+
+    SECTION("#01: Extract entries in the order of the archive file") {
+        for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::MemoryMapped }) {
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode);
+
+            std::vector<std::string>           order;
+            std::map<std::string, std::string> results;
+            archive.extract(names, [&](std::string_view name, const std::vector<unsigned char>& data) {
+                order.emplace_back(name);
+                results[std::string(name)] = std::string(data.begin(), data.end());
+            });
+
+            REQUIRE(results.size() == names.size());
+            for (int i = 0; i < 200; i += 2) REQUIRE(results[nameOf(i)] == contentOf(i));
+            REQUIRE(results["Folder 1/"].empty());
+
+            // ===== The folder entry isn't in the archive file, so it isn't part of the ordering.
+            order.erase(std::remove(order.begin(), order.end(), "Folder 1/"), order.end());
+            for (std::size_t i = 0; i < order.size(); ++i) REQUIRE(order[i] == nameOf(static_cast<int>(i) * 2));
+        }
+    }
+
+    SECTION("#02: Extract modified entries") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.entry(nameOf(10)) = std::string("modified");
+
+        std::map<std::string, std::string> results;
+        archive.extract({ nameOf(10), nameOf(12) }, [&](std::string_view name, const std::vector<unsigned char>& data) {
+            results[std::string(name)] = std::string(data.begin(), data.end());
+        });
+        REQUIRE(results[nameOf(10)] == "modified");
+        REQUIRE(results[nameOf(12)] == contentOf(12));
+    }
+
+    SECTION("#03: Unknown entries are reported before anything is extracted") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+
+        auto callCount = 0;
+        REQUIRE_THROWS_AS(archive.extract({ nameOf(0), "unknown.txt" }, [&](std::string_view, const std::vector<unsigned char>&) { ++callCount; }),
+                          KZip::ZipLogicError);
+        REQUIRE(callCount == 0);
+    }
+}
+
+TEST_CASE("TEST 18: Extract Entries Asynchronously") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    auto              nameOf      = [](int i) { return "Folder " + std::to_string(i % 4) + "/file " + std::to_string(i) + ".txt"; };
+    auto              contentOf   = [](int i) { return std::string(i == 50 ? 5000000 : i * 100, static_cast<char>('a' + i % 26)) + std::to_string(i); };
+    {
+        mz_zip_archive writer = mz_zip_archive();
+        mz_zip_writer_init_file(&writer, archivePath.c_str(), 0);
+        for (int i = 0; i < 200; ++i) {
+            auto content = contentOf(i);
+            mz_zip_writer_add_mem(&writer, nameOf(i).c_str(), content.data(), content.size(), i % 3 ? MZ_DEFAULT_COMPRESSION : MZ_NO_COMPRESSION);
+        }
+        mz_zip_writer_finalize_archive(&writer);
+        mz_zip_writer_end(&writer);
+    }
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; ++i) names.push_back(nameOf((i * 37) % 200));
+    names.emplace_back("Folder 1/");
+
+    SECTION("#01: Extract entries on worker threads") {
+        for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::MemoryMapped }) {
+            for (std::size_t threadCount : { 1, 4 }) {
+                KZip::ZipArchive archive;
+                archive.open(archivePath, mode);
+
+                std::mutex                         mutex;
+                std::map<std::string, std::string> results;
+                auto future = archive.extractAsync(names, [&](std::string_view name, const std::vector<unsigned char>& data) {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    results[std::string(name)] = std::string(data.begin(), data.end());
+                }, threadCount);
+                future.get();
+
+                REQUIRE(results.size() == names.size());
+                for (int i = 0; i < 200; ++i) REQUIRE(results[nameOf(i)] == contentOf(i));
+                REQUIRE(results["Folder 1/"].empty());
+            }
+        }
+    }
+
+    SECTION("#02: Extract modified entries") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.entry(nameOf(10)) = std::string("modified");
+
+        std::mutex                         mutex;
+        std::map<std::string, std::string> results;
+        archive.extractAsync({ nameOf(10), nameOf(12) }, [&](std::string_view name, const std::vector<unsigned char>& data) {
+            std::lock_guard<std::mutex> guard(mutex);
+            results[std::string(name)] = std::string(data.begin(), data.end());
+        }).get();
+        REQUIRE(results[nameOf(10)] == "modified");
+        REQUIRE(results[nameOf(12)] == contentOf(12));
+    }
+
+    SECTION("#03: Errors are reported to the caller") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+
+        std::atomic<int> callCount { 0 };
+        REQUIRE_THROWS_AS(archive.extractAsync({ nameOf(0), "unknown.txt" }, [&](std::string_view, const std::vector<unsigned char>&) { ++callCount; }),
+                          KZip::ZipLogicError);
+        REQUIRE(callCount == 0);
+
+        auto future = archive.extractAsync(names, [&](std::string_view, const std::vector<unsigned char>&) {
+            if (++callCount == 3) throw std::runtime_error("sink failed");
+        });
+        REQUIRE_THROWS_AS(future.get(), std::runtime_error);
+    }
+
+    SECTION("#04: Closing the archive waits for the extraction to finish") {
+        for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::MemoryMapped }) {
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode);
+
+            std::atomic<int> callCount { 0 };
+            auto future = archive.extractAsync(names, [&](std::string_view, const std::vector<unsigned char>&) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                ++callCount;
+            }, 2);
+            archive.close();
+            REQUIRE(callCount == static_cast<int>(names.size()));
+            REQUIRE_NOTHROW(future.get());
+        }
+    }
+}
+
+TEST_CASE("TEST 19: Read Compressed Data") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    auto              contentOf   = [](int i) { return std::string(i * 1000, static_cast<char>('a' + i)) + std::to_string(i); };
+    {
+        mz_zip_archive writer = mz_zip_archive();
+        mz_zip_writer_init_file(&writer, archivePath.c_str(), 0);
+        for (int i = 0; i < 4; ++i) {
+            auto content = contentOf(i);
+            auto name    = "file " + std::to_string(i) + ".txt";
+            mz_zip_writer_add_mem(&writer, name.c_str(), content.data(), content.size(), i % 2 ? MZ_DEFAULT_COMPRESSION : MZ_NO_COMPRESSION);
+        }
+        mz_zip_writer_finalize_archive(&writer);
+        mz_zip_writer_end(&writer);
+    }
+
+    auto inflate = [](const KZip::ZipCompressedData& data) {
+        if (data.method() == 0) return std::string(data.data(), data.data() + data.size());
+        std::string result(data.uncompressedSize(), '\0');
+        result.resize(tinfl_decompress_mem_to_mem(result.data(), result.size(), data.data(), data.size(), 0));
+        return result;
+    };
+
+    SECTION("#01: Get the compressed data of entries") {
+        for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::MemoryMapped }) {
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode);
+
+            for (int i = 0; i < 4; ++i) {
+                auto data = archive.entry("file " + std::to_string(i) + ".txt").rawCompressed();
+                REQUIRE(data.method() == (i % 2 ? MZ_DEFLATED : 0));
+                REQUIRE(data.uncompressedSize() == contentOf(i).size());
+                REQUIRE(data.isCopy() == (mode == KZip::OpenMode::Default));
+                REQUIRE(inflate(data) == contentOf(i));
+                REQUIRE(data.crc32() == mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(contentOf(i).data()), contentOf(i).size()));
+            }
+        }
+    }
+
+    SECTION("#02: Read the compressed data as a stream") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+
+        auto reader = archive.entry("file 3.txt").openRawStream();
+        auto data   = archive.entry("file 3.txt").rawCompressed();
+        REQUIRE(reader.size() == data.size());
+
+        std::vector<unsigned char> chunk(100);
+        std::vector<unsigned char> result;
+        while (auto count = reader.read(chunk.data(), chunk.size())) result.insert(result.end(), chunk.begin(), chunk.begin() + count);
+        REQUIRE(result == std::vector<unsigned char>(data.data(), data.data() + data.size()));
+    }
+
+    SECTION("#03: Modified entries are returned as stored") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.entry("file 1.txt") = std::string("modified");
+
+        auto data = archive.entry("file 1.txt").rawCompressed();
+        REQUIRE(data.method() == 0);
+        REQUIRE(inflate(data) == "modified");
+        REQUIRE_FALSE(data.isCopy());
+    }
+
+    SECTION("#04: Renamed entries are saved under the new name") {
+        {
+            KZip::ZipArchive archive;
+            archive.open(archivePath);
+            archive.entry("file 0.txt").setName("renamed 0.txt");
+            archive.entry("file 1.txt").setName("folder/renamed 1.txt");
+            archive.save();
+        }
+
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        REQUIRE_FALSE(archive.hasEntry("file 0.txt"));
+        REQUIRE_FALSE(archive.hasEntry("file 1.txt"));
+        REQUIRE(archive.entry("renamed 0.txt").getData<std::string>() == contentOf(0));
+        REQUIRE(archive.entry("folder/renamed 1.txt").getData<std::string>() == contentOf(1));
+        REQUIRE(archive.entry("folder/renamed 1.txt").rawCompressed().method() == MZ_DEFLATED);
+        REQUIRE(archive.entry("file 2.txt").getData<std::string>() == contentOf(2));
+    }
+}
+
+TEST_CASE("TEST 20: View Stored Entries") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    auto              contentOf   = [](int i) { return std::string(i * 1000, static_cast<char>('a' + i)) + std::to_string(i); };
+    {
+        mz_zip_archive writer = mz_zip_archive();
+        mz_zip_writer_init_file(&writer, archivePath.c_str(), 0);
+        for (int i = 0; i < 4; ++i) {
+            auto content = contentOf(i);
+            auto name    = "file " + std::to_string(i) + ".txt";
+            mz_zip_writer_add_mem(&writer, name.c_str(), content.data(), content.size(), i % 2 ? MZ_DEFAULT_COMPRESSION : MZ_NO_COMPRESSION);
+        }
+        mz_zip_writer_finalize_archive(&writer);
+        mz_zip_writer_end(&writer);
+    }
+
+    SECTION("#01: View stored entries in a memory mapped archive") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath, KZip::OpenMode::MemoryMapped);
+
+        for (int i = 0; i < 4; ++i) {
+            auto view = archive.entry("file " + std::to_string(i) + ".txt").view();
+            if (i % 2) {
+                REQUIRE_FALSE(view.has_value());
+                continue;
+            }
+
+            REQUIRE(view.has_value());
+            REQUIRE(std::string(view->begin(), view->end()) == contentOf(i));
+
+            // ===== The view refers to the same bytes on every call, i.e. nothing is copied.
+            REQUIRE(archive.entry("file " + std::to_string(i) + ".txt").view()->data() == view->data());
+        }
+    }
+
+    SECTION("#02: Entries can't be viewed if the archive isn't memory mapped") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        REQUIRE_FALSE(archive.entry("file 0.txt").view().has_value());
+        REQUIRE_FALSE(archive.entry("file 1.txt").view().has_value());
+    }
+
+    SECTION("#03: View new and modified entries") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.entry("file 1.txt") = std::string("modified");
+        archive.addEntry("new file.txt");
+
+        auto view = archive.entry("file 1.txt").view();
+        REQUIRE(view.has_value());
+        REQUIRE(std::string(view->begin(), view->end()) == "modified");
+        REQUIRE(archive.entry("new file.txt").view()->empty());
+    }
+}
+
+TEST_CASE("TEST 21: Compute CRC-32 Checksums") {
+
+    using KZip::Impl::Crc32Engine;
+    std::vector<unsigned char> data(1 << 20);
+    std::mt19937               generator(42);
+    for (auto& byte : data) byte = static_cast<unsigned char>(generator());
+
+    SECTION("#01: All supported implementations compute the same checksum") {
+        for (auto engine : { Crc32Engine::Bytewise, Crc32Engine::SliceBy16, Crc32Engine::Clmul, Crc32Engine::ArmCrc }) {
+            if (!KZip::Impl::isSupported(engine)) continue;
+
+            const std::string check = "123456789";
+            REQUIRE(KZip::Impl::updateCrc32(engine, 0, reinterpret_cast<const unsigned char*>(check.data()), check.size()) == 0xCBF43926);
+            REQUIRE(KZip::Impl::updateCrc32(engine, 0, data.data(), 0) == 0);
+
+            // ===== Check all sizes up to a few blocks, at all alignments, and a large buffer in uneven parts.
+            for (std::size_t offset = 0; offset < 16; ++offset) {
+                for (std::size_t size = 0; size < 300; ++size) {
+                    auto expected = KZip::Impl::updateCrc32(Crc32Engine::Bytewise, 0, data.data() + offset, size);
+                    REQUIRE(KZip::Impl::updateCrc32(engine, 0, data.data() + offset, size) == expected);
+                }
+            }
+
+            auto expected = KZip::Impl::updateCrc32(Crc32Engine::Bytewise, 0, data.data(), data.size());
+            auto crc      = KZip::Impl::updateCrc32(engine, 0, data.data(), 100003);
+            crc           = KZip::Impl::updateCrc32(engine, crc, data.data() + 100003, data.size() - 100003);
+            REQUIRE(crc == expected);
+        }
+    }
+
+    SECTION("#02: mz_crc32 uses the selected implementation") {
+        REQUIRE(KZip::Impl::isSupported(KZip::Impl::crc32Engine()));
+        REQUIRE(mz_crc32(MZ_CRC32_INIT, nullptr, 0) == MZ_CRC32_INIT);
+        REQUIRE(mz_crc32(MZ_CRC32_INIT, data.data(), data.size()) == KZip::Impl::updateCrc32(Crc32Engine::Bytewise, 0, data.data(), data.size()));
+    }
+}
+
+TEST_CASE("TEST 22: Verify Checksums") {
+
+    const std::string archivePath = "./TestArchive.zip";
+    auto              contentOf   = [](int i) { return std::string((i + 1) * 1000, static_cast<char>('a' + i)) + std::to_string(i); };
+    auto              nameOf      = [](int i) { return "file " + std::to_string(i) + ".txt"; };
+    {
+        mz_zip_archive writer = mz_zip_archive();
+        mz_zip_writer_init_file(&writer, archivePath.c_str(), 0);
+        for (int i = 0; i < 4; ++i) {
+            auto content = contentOf(i);
+            mz_zip_writer_add_mem(&writer, nameOf(i).c_str(), content.data(), content.size(), i % 2 ? MZ_DEFAULT_COMPRESSION : MZ_NO_COMPRESSION);
+        }
+        mz_zip_writer_finalize_archive(&writer);
+        mz_zip_writer_end(&writer);
+    }
+
+    // ===== Overwrite part of the archive file in place.
+    auto patchFile = [&](std::streamoff offset, const std::string& bytes) {
+        std::fstream file(archivePath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    };
+    auto fileContent = [&]() {
+        std::ifstream file(archivePath, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+
+    // ===== Corrupt the checksums of entries 0 (stored) and 1 (deflated) in the central directory.
+    {
+        auto content = fileContent();
+        for (int i = 0; i < 2; ++i) {
+            auto offset = content.find(nameOf(i), content.find("PK\1\2"));
+            REQUIRE(offset != std::string::npos);
+            auto position = offset - MZ_ZIP_CENTRAL_DIR_HEADER_SIZE + MZ_ZIP_CDH_CRC32_OFS;
+            patchFile(static_cast<std::streamoff>(position), std::string(1, static_cast<char>(~content[position])));
+        }
+    }
+
+    auto readStream = [](KZip::ZipEntryReader reader) {
+        std::vector<unsigned char> chunk(100);
+        std::string                result;
+        while (auto count = reader.read(chunk.data(), chunk.size())) result.append(chunk.begin(), chunk.begin() + count);
+        return result;
+    };
+
+    SECTION("#01: Checksums are verified on every read by default") {
+        for (auto mode : { KZip::OpenMode::Default, KZip::OpenMode::MemoryMapped }) {
+            KZip::ZipArchive archive;
+            archive.open(archivePath, mode);
+            REQUIRE(archive.verification() == KZip::ZipVerification::Always);
+
+            for (int i = 0; i < 2; ++i) {
+                auto& entry = archive.entry(nameOf(i));
+                REQUIRE_THROWS_AS(entry.getData<std::string>(), KZip::ZipRuntimeError);
+                REQUIRE_THROWS_AS(entry.getData<std::string>(), KZip::ZipRuntimeError);
+                REQUIRE_THROWS_AS(readStream(entry.openStream()), KZip::ZipRuntimeError);
+                REQUIRE_THROWS_AS(archive.extract({ nameOf(i) }, [](std::string_view, const std::vector<unsigned char>&) {}),
+                                  KZip::ZipRuntimeError);
+                REQUIRE_THROWS_AS(archive.extractAsync({ nameOf(i) }, [](std::string_view, const std::vector<unsigned char>&) {}).get(),
+                                  KZip::ZipRuntimeError);
+            }
+            REQUIRE(archive.entry(nameOf(2)).getData<std::string>() == contentOf(2));
+            REQUIRE(archive.entry(nameOf(3)).getData<std::string>() == contentOf(3));
+        }
+    }
+
+    SECTION("#02: Checksums are not verified if disabled for the archive") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.setVerification(KZip::ZipVerification::Never);
+
+        for (int i = 0; i < 4; ++i) {
+            auto& entry = archive.entry(nameOf(i));
+            REQUIRE(entry.getData<std::string>() == contentOf(i));
+            REQUIRE(readStream(entry.openStream()) == contentOf(i));
+        }
+
+        std::map<std::string, std::string> extracted;
+        archive.extract({ nameOf(0), nameOf(1) }, [&](std::string_view name, const std::vector<unsigned char>& data) {
+            extracted[std::string(name)] = std::string(data.begin(), data.end());
+        });
+        REQUIRE(extracted[nameOf(0)] == contentOf(0));
+        REQUIRE(extracted[nameOf(1)] == contentOf(1));
+
+        const std::filesystem::path directory = "./VerifyChecksums";
+        std::filesystem::remove_all(directory);
+        archive.extractAll(directory);
+        std::ifstream file(directory / nameOf(1), std::ios::binary);
+        REQUIRE(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()) == contentOf(1));
+        file.close();
+        std::filesystem::remove_all(directory);
+
+        archive.setVerification(KZip::ZipVerification::Default);
+        REQUIRE(archive.verification() == KZip::ZipVerification::Always);
+    }
+
+    SECTION("#03: The policy can be selected per read") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+
+        auto& entry = archive.entry(nameOf(1));
+        REQUIRE(entry.getData<std::string>(KZip::ZipVerification::Never) == contentOf(1));
+        REQUIRE(readStream(entry.openStream(KZip::ZipVerification::Never)) == contentOf(1));
+        REQUIRE_THROWS_AS(entry.getData<std::string>(KZip::ZipVerification::FirstRead), KZip::ZipRuntimeError);
+
+        archive.setVerification(KZip::ZipVerification::Never);
+        std::string data;
+        REQUIRE_THROWS_AS(entry.readInto(data, KZip::ZipVerification::Always), KZip::ZipRuntimeError);
+        REQUIRE_NOTHROW(entry.readInto(data));
+    }
+
+    SECTION("#04: Checksums are verified until the first successful verification") {
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        archive.setVerification(KZip::ZipVerification::FirstRead);
+
+        // ===== Entries with bad checksums fail on every read, as they are never verified.
+        REQUIRE_THROWS_AS(archive.entry(nameOf(0)).getData<std::string>(), KZip::ZipRuntimeError);
+        REQUIRE_THROWS_AS(archive.entry(nameOf(0)).getData<std::string>(), KZip::ZipRuntimeError);
+
+        // ===== Once an entry has been verified, changes to its data on disk are only detected by verified reads.
+        REQUIRE(archive.entry(nameOf(2)).getData<std::string>() == contentOf(2));
+        auto offset = fileContent().find(contentOf(2));
+        REQUIRE(offset != std::string::npos);
+        patchFile(static_cast<std::streamoff>(offset), "X");
+
+        auto expected = "X" + contentOf(2).substr(1);
+        REQUIRE(archive.entry(nameOf(2)).getData<std::string>() == expected);
+        REQUIRE_THROWS_AS(archive.entry(nameOf(2)).getData<std::string>(KZip::ZipVerification::Always), KZip::ZipRuntimeError);
+
+        // ===== The verification results are not kept when the archive is reopened.
+        archive.close();
+        archive.open(archivePath);
+        archive.setVerification(KZip::ZipVerification::FirstRead);
+        REQUIRE_THROWS_AS(archive.entry(nameOf(2)).getData<std::string>(), KZip::ZipRuntimeError);
+    }
+}
+
+TEST_CASE("TEST 23: Inflate Engines") {
+
+    using KZip::ZipInflateEngine;
+
+    // ===== Text with long matches, and binary records with short matches and random bytes.
+    std::string   data;
+    std::mt19937  generator(42);
+    const char*   words[] = { "the ", "archive ", "entry ", "<item>", "</item>\n", "deflate ", "zip ", "of " };
+    while (data.size() < 200000) data += words[generator() % 8];
+    for (uint32_t i = 0; i < 20000; ++i) {
+        data.append(reinterpret_cast<const char*>(&i), sizeof i);
+        data += static_cast<char>(generator());
+        data.append(3, '\0');
+    }
+
+    auto compress = [&](int level, int strategy) {
+        std::size_t size   = 0;
+        auto*       buffer = tdefl_compress_mem_to_heap(data.data(), data.size(), &size, tdefl_create_comp_flags_from_zip_params(level, -15, strategy));
+        REQUIRE(buffer != nullptr);
+        std::vector<unsigned char> result(static_cast<unsigned char*>(buffer), static_cast<unsigned char*>(buffer) + size);
+        mz_free(buffer);
+        return result;
+    };
+    auto decompress = [&](ZipInflateEngine engine, const std::vector<unsigned char>& compressed, std::size_t size) {
+        std::string result(size, '\0');
+        auto        count = KZip::Impl::inflateBuffer(engine, compressed.data(), compressed.size(), reinterpret_cast<unsigned char*>(result.data()), size);
+        return count == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED ? std::string("failed") : result.substr(0, count);
+    };
+
+    SECTION("#01: Both engines decompress stored, fixed and dynamic Huffman blocks") {
+        for (auto level : { 0, 1, 6, 10 }) {
+            for (auto strategy : { MZ_DEFAULT_STRATEGY, MZ_FIXED }) {
+                auto compressed = compress(level, strategy);
+                REQUIRE(decompress(ZipInflateEngine::Miniz, compressed, data.size()) == data);
+                REQUIRE(decompress(ZipInflateEngine::Fast, compressed, data.size()) == data);
+            }
+        }
+    }
+
+    SECTION("#02: Both engines fail on corrupt and truncated streams") {
+        auto compressed = compress(6, MZ_DEFAULT_STRATEGY);
+        REQUIRE(decompress(ZipInflateEngine::Fast, compressed, data.size() - 1) == "failed");
+        REQUIRE(decompress(ZipInflateEngine::Fast, { compressed.begin(), compressed.end() - 10 }, data.size()) == "failed");
+
+        for (int i = 0; i < 200; ++i) {
+            auto corrupted = compressed;
+            corrupted[generator() % corrupted.size()] ^= static_cast<unsigned char>(1U << (generator() % 8));
+            REQUIRE(decompress(ZipInflateEngine::Fast, corrupted, data.size()) == decompress(ZipInflateEngine::Miniz, corrupted, data.size()));
+        }
+    }
+
+    SECTION("#03: The engine can be selected for the archive") {
+        const std::string archivePath = "./TestArchive.zip";
+        {
+            KZip::ZipArchive archive;
+            archive.create(archivePath);
+            archive.addEntry("data.bin") = data;
+            archive.save();
+        }
+
+        KZip::ZipArchive archive;
+        archive.open(archivePath);
+        REQUIRE(archive.inflateEngine() == ZipInflateEngine::Fast);
+        REQUIRE(archive.entry("data.bin").getData<std::string>() == data);
+
+        archive.setInflateEngine(ZipInflateEngine::Miniz);
+        REQUIRE(archive.inflateEngine() == ZipInflateEngine::Miniz);
+        REQUIRE(archive.entry("data.bin").getData<std::string>() == data);
+
+        std::string buffer;
+        archive.setInflateEngine(ZipInflateEngine::Fast);
+        archive.entry("data.bin").readInto(buffer);
+        REQUIRE(buffer == data);
+    }
+}